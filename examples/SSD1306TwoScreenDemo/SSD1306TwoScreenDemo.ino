@@ -31,26 +31,26 @@
 // For a connection via I2C using Wire include
 #include <Wire.h>  // Only needed for Arduino 1.6.5 and earlier
 #include "SSD1306Wire.h" // legacy include: `#include "SSD1306.h"`
+#include "OLEDDisplayGroup.h"
 #include "images.h"
 
 // Initialize the OLED display using Wire library
 SSD1306Wire  display(0x3c, D3, D5);
 SSD1306Wire  display2(0x3c, D1, D2);
 
+// The group binds the Wire library to the pins of the display it sends
+// data or commands to and lets the displays take turns
+OLEDDisplayGroup displays;
+
 void setup() {
   Serial.begin(115200);
   Serial.println();
   Serial.println();
 
 
-  // Initialising the UI will init the display too.
-  display.init();
-  display2.init();
-
-  // This will make sure that multiple instances of a display driver
-  // running on different ports will work together transparently
-  display.setI2cAutoInit(true);
-  display2.setI2cAutoInit(true);
+  displays.add(&display);
+  displays.add(&display2);
+  displays.init();
 
   display.flipScreenVertically();
   display.setFont(ArialMT_Plain_10);
@@ -65,11 +65,11 @@ void setup() {
 void loop() {
   display.clear();
   display.drawString(0, 0, "Hello world: " + String(millis()));
-  display.display();
 
   display2.clear();
   display2.drawString(0, 0, "Hello world: " + String(millis()));
-  display2.display();
+
+  displays.display();
 
   delay(10);
 }
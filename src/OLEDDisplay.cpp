@@ -36,6 +36,7 @@
  */
 
 #include "OLEDDisplay.h"
+#include "OLEDDisplayGroup.h"
 
 #ifndef MIN
 #define MIN(a, b) ({ __typeof__ (a) _a = (a);  __typeof__ (b) _b = (b);  _a < _b ? _a : _b; })
@@ -46,6 +47,17 @@ OLEDDisplay::OLEDDisplay() {
     displayWidth = 128;
     displayHeight = 64;
     displayBufferSize = displayWidth * displayHeight / 8;
+    stripPages = 0;
+    bufferFirstPage = 0;
+    bufferLent = false;
+    rotation = ROTATE_0;
+    rotatedPage = NULL;
+    flushPerPage = false;
+    busClock = 0;
+    busErrors = 0;
+    busErrorsInRow = 0;
+    busTuning = false;
+    group = NULL;
     color = WHITE;
     geometry = GEOMETRY_128_64;
     textAlignment = TEXT_ALIGN_LEFT;
@@ -55,9 +67,18 @@ OLEDDisplay::OLEDDisplay() {
 #ifdef OLEDDISPLAY_DOUBLE_BUFFER
     buffer_back = NULL;
 #endif
+    canvas = NULL;
+    logBuffer = NULL;
+    logBufferLineStarts = NULL;
+    mirrorCount = 0;
+    scrollActive = false;
+    startLinePage = 0;
+    logBufferHardwareScroll = false;
+    resetClip();
 }
 
 OLEDDisplay::~OLEDDisplay() {
+    if (group != NULL) group->remove(this);
     end();
 }
 
@@ -67,7 +88,12 @@ bool OLEDDisplay::allocateBuffer() {
     logBufferFilled = 0;
     logBufferLine = 0;
     logBufferMaxLines = 0;
+    logBufferScrolledLines = 0;
+    logBufferChangedLine = 0;
+    logBufferStart = 0;
     logBuffer = NULL;
+    logBufferLineStarts = NULL;
+    logBufferFirstLine = 0;
 
     if (!this->connect()) {
         DEBUG_OLEDDISPLAY("[OLEDDISPLAY][init] Can't establish connection to display\n");
@@ -85,7 +111,8 @@ bool OLEDDisplay::allocateBuffer() {
     }
 
 #ifdef OLEDDISPLAY_DOUBLE_BUFFER
-    if (this->buffer_back == NULL) {
+    // Strips are sent as they are drawn, there is nothing to compare them to
+    if (this->buffer_back == NULL && stripPages == 0) {
         this->buffer_back = (uint8_t *) malloc((sizeof(uint8_t) * displayBufferSize) + getBufferOffset());
         this->buffer_back += getBufferOffset();
 
@@ -97,6 +124,28 @@ bool OLEDDisplay::allocateBuffer() {
     }
 #endif
 
+    // The rotation may have been set before, or kept over end()
+    if (!allocateRotatedPage(rotation)) {
+        return false;
+    }
+
+    return true;
+}
+
+bool OLEDDisplay::allocateRotatedPage(OLEDDISPLAY_ROTATION rotation) {
+    if (rotation == ROTATE_0) {
+        free(this->rotatedPage);
+        this->rotatedPage = NULL;
+        return true;
+    }
+
+    if (this->rotatedPage == NULL) {
+        this->rotatedPage = (uint8_t *) malloc(getBufferOffset() + panelWidth());
+        if (!this->rotatedPage) {
+            DEBUG_OLEDDISPLAY("[OLEDDISPLAY][allocateRotatedPage] Not enough memory to rotate the display\n");
+            return false;
+        }
+    }
     return true;
 }
 
@@ -113,6 +162,7 @@ bool OLEDDisplay::init() {
 }
 
 void OLEDDisplay::end() {
+    resetCanvas();
     if (this->buffer) {
         free(this->buffer - getBufferOffset());
         this->buffer = NULL;
@@ -123,13 +173,26 @@ void OLEDDisplay::end() {
         this->buffer_back = NULL;
     }
 #endif
+    if (this->rotatedPage) {
+        free(this->rotatedPage);
+        this->rotatedPage = NULL;
+    }
     if (this->logBuffer != NULL) {
         free(this->logBuffer);
         this->logBuffer = NULL;
     }
+    if (this->logBufferLineStarts != NULL) {
+        free(this->logBufferLineStarts);
+        this->logBufferLineStarts = NULL;
+    }
 }
 
 void OLEDDisplay::resetDisplay(void) {
+    if (stripPages > 0) {
+        drawStrips(NULL);
+        return;
+    }
+
     clear();
 #ifdef OLEDDISPLAY_DOUBLE_BUFFER
     memset(buffer_back, 1, displayBufferSize);
@@ -137,6 +200,70 @@ void OLEDDisplay::resetDisplay(void) {
     display();
 }
 
+void OLEDDisplay::setStripHeight(uint8_t pages) {
+    // The buffer has its size already, strips are pages of the panel
+    if (this->buffer != NULL || rotation != ROTATE_0) return;
+
+    this->stripPages = pages < this->height() / 8 ? pages : 0;
+    this->displayBufferSize = this->width() * (stripPages ? stripPages * 8 : this->height()) / 8;
+    resetClip();
+}
+
+void OLEDDisplay::drawStrips(OLEDDisplayDrawCallback callback) {
+    if (stripPages == 0) {
+        clear();
+        if (callback) callback(this);
+        display();
+        return;
+    }
+
+    uint8_t *strip = this->buffer;
+    uint8_t pages = this->height() / 8;
+
+    for (uint8_t page = 0; page < pages; page += stripPages) {
+        bufferFirstPage = page;
+        this->buffer = strip - page * this->width();
+        resetClip();
+        clear();
+        if (callback) callback(this);
+        display();
+    }
+
+    bufferFirstPage = 0;
+    this->buffer = strip;
+    resetClip();
+}
+
+void OLEDDisplay::setClipRect(int16_t x, int16_t y, int16_t width, int16_t height) {
+    // Resolve the clip rectangle against the buffer once, so that the
+    // primitives only need to check against the clip rectangle
+    resetClip();
+    if (x > clipX0) clipX0 = x;
+    if (y > clipY0) clipY0 = y;
+    if (x + width < clipX1) clipX1 = x + width;
+    if (y + height < clipY1) clipY1 = y + height;
+
+    // An empty clip rectangle rejects everything
+    if (clipX1 < clipX0) clipX1 = clipX0;
+    if (clipY1 < clipY0) clipY1 = clipY0;
+}
+
+void OLEDDisplay::resetClip() {
+    // The rows held by the buffer
+    clipX0 = 0;
+    clipY0 = bufferFirstPage * 8;
+    clipX1 = this->width();
+    clipY1 = clipY0 + displayBufferSize / this->width() * 8;
+    if (clipY1 > this->height()) clipY1 = this->height();
+}
+
+void OLEDDisplay::getClipRect(int16_t *x, int16_t *y, int16_t *width, int16_t *height) {
+    *x = clipX0;
+    *y = clipY0;
+    *width = clipX1 - clipX0;
+    *height = clipY1 - clipY0;
+}
+
 void OLEDDisplay::setColor(OLEDDISPLAY_COLOR color) {
     this->color = color;
 }
@@ -146,7 +273,7 @@ OLEDDISPLAY_COLOR OLEDDisplay::getColor() {
 }
 
 void OLEDDisplay::setPixel(int16_t x, int16_t y) {
-    if (x >= 0 && x < this->width() && y >= 0 && y < this->height()) {
+    if (x >= clipX0 && x < clipX1 && y >= clipY0 && y < clipY1) {
         switch (color) {
             case WHITE:
                 buffer[x + (y / 8) * this->width()] |= (1 << (y & 7));
@@ -162,7 +289,7 @@ void OLEDDisplay::setPixel(int16_t x, int16_t y) {
 }
 
 void OLEDDisplay::setPixelColor(int16_t x, int16_t y, OLEDDISPLAY_COLOR color) {
-    if (x >= 0 && x < this->width() && y >= 0 && y < this->height()) {
+    if (x >= clipX0 && x < clipX1 && y >= clipY0 && y < clipY1) {
         switch (color) {
             case WHITE:
                 buffer[x + (y / 8) * this->width()] |= (1 << (y & 7));
@@ -178,7 +305,7 @@ void OLEDDisplay::setPixelColor(int16_t x, int16_t y, OLEDDISPLAY_COLOR color) {
 }
 
 void OLEDDisplay::clearPixel(int16_t x, int16_t y) {
-    if (x >= 0 && x < this->width() && y >= 0 && y < this->height()) {
+    if (x >= clipX0 && x < clipX1 && y >= clipY0 && y < clipY1) {
         switch (color) {
             case BLACK:
                 buffer[x + (y >> 3) * this->width()] |= (1 << (y & 7));
@@ -194,6 +321,26 @@ void OLEDDisplay::clearPixel(int16_t x, int16_t y) {
 }
 
 
+void inline OLEDDisplay::setPixelUnchecked(int16_t x, int16_t y) {
+    switch (color) {
+        case WHITE:
+            buffer[x + (y >> 3) * this->width()] |= (1 << (y & 7));
+            break;
+        case BLACK:
+            buffer[x + (y >> 3) * this->width()] &= ~(1 << (y & 7));
+            break;
+        case INVERSE:
+            buffer[x + (y >> 3) * this->width()] ^= (1 << (y & 7));
+            break;
+    }
+}
+
+void inline OLEDDisplay::setRowPixels(int16_t y, int16_t xLeft, int16_t xRight, bool left, bool right) {
+    if (y < clipY0 || y >= clipY1) return;
+    if (left && xLeft >= clipX0 && xLeft < clipX1) setPixelUnchecked(xLeft, y);
+    if (right && xRight >= clipX0 && xRight < clipX1) setPixelUnchecked(xRight, y);
+}
+
 // Bresenham's algorithm - thx wikipedia and Adafruit_GFX
 void OLEDDisplay::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
     int16_t steep = abs(y1 - y0) > abs(x1 - x0);
@@ -220,11 +367,43 @@ void OLEDDisplay::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
         ystep = -1;
     }
 
-    for (; x0 <= x1; x0++) {
+    // The clip rectangle along the x (major) and y (minor) axis of the loop, exclusive ends
+    int16_t majorMin = steep ? clipY0 : clipX0;
+    int16_t majorMax = steep ? clipY1 : clipX1;
+    int16_t minorMin = steep ? clipX0 : clipY0;
+    int16_t minorMax = steep ? clipX1 : clipY1;
+
+    // Clip once: after n steps y has moved k = ceil((n * dy - dx / 2) / dx) times, so the steps
+    // that stay inside follow from the error term and the same pixels are set as without clipping
+    int32_t first = x0 < majorMin ? majorMin - x0 : 0;
+    int32_t last = x1 >= majorMax ? majorMax - 1 - x0 : dx;
+    if (dy > 0) {
+        // y steps before the line enters the clip rectangle and until it leaves it
+        int32_t enter = ystep > 0 ? minorMin - y0 : y0 - (minorMax - 1);
+        int32_t leave = ystep > 0 ? minorMax - 1 - y0 : y0 - minorMin;
+        if (leave < 0) return;
+        if (enter > 0) {
+            int32_t n = ((int32_t) (enter - 1) * dx + err) / dy + 1;
+            if (n > first) first = n;
+        }
+        int32_t n = ((int32_t) leave * dx + err) / dy;
+        if (n < last) last = n;
+    } else if (y0 < minorMin || y0 >= minorMax) {
+        return;
+    }
+    if (first > last) return;
+
+    // Start at the first step inside
+    int32_t progress = first * dy - err;
+    int32_t k = progress > 0 ? (progress + dx - 1) / dx : 0;
+    err = err - first * dy + k * dx;
+    y0 += k * ystep;
+
+    for (int16_t x = x0 + first; x <= x0 + last; x++) {
         if (steep) {
-            setPixel(y0, x0);
+            setPixelUnchecked(y0, x);
         } else {
-            setPixel(x0, y0);
+            setPixelUnchecked(x, y0);
         }
         err -= dy;
         if (err < 0) {
@@ -242,12 +421,21 @@ void OLEDDisplay::drawRect(int16_t x, int16_t y, int16_t width, int16_t height)
 }
 
 void OLEDDisplay::fillRect(int16_t xMove, int16_t yMove, int16_t width, int16_t height) {
-    for (int16_t x = xMove; x < xMove + width; x++) {
+    int16_t xEnd = xMove + width;
+    if (xMove < clipX0) xMove = clipX0;
+    if (xEnd > clipX1) xEnd = clipX1;
+    if (yMove >= clipY1 || yMove + height <= clipY0) return;
+
+    for (int16_t x = xMove; x < xEnd; x++) {
         drawVerticalLine(x, yMove, height);
     }
 }
 
 void OLEDDisplay::drawCircle(int16_t x0, int16_t y0, int16_t radius) {
+    // A radius of 0 still touches the neighbouring pixels
+    int16_t reach = radius > 0 ? radius : 1;
+    if (x0 + reach < clipX0 || x0 - reach >= clipX1 || y0 + reach < clipY0 || y0 - reach >= clipY1) return;
+
     int16_t x = 0, y = radius;
     int16_t dp = 1 - radius;
     do {
@@ -256,24 +444,24 @@ void OLEDDisplay::drawCircle(int16_t x0, int16_t y0, int16_t radius) {
         else
             dp = dp + (x++) * 2 - (y--) * 2 + 5;
 
-        setPixel(x0 + x, y0 + y);     //For the 8 octants
-        setPixel(x0 - x, y0 + y);
-        setPixel(x0 + x, y0 - y);
-        setPixel(x0 - x, y0 - y);
-        setPixel(x0 + y, y0 + x);
-        setPixel(x0 - y, y0 + x);
-        setPixel(x0 + y, y0 - x);
-        setPixel(x0 - y, y0 - x);
+        setRowPixels(y0 + y, x0 - x, x0 + x);     //For the 8 octants
+        setRowPixels(y0 - y, x0 - x, x0 + x);
+        setRowPixels(y0 + x, x0 - y, x0 + y);
+        setRowPixels(y0 - x, x0 - y, x0 + y);
 
     } while (x < y);
 
-    setPixel(x0 + radius, y0);
+    setRowPixels(y0, x0 - radius, x0 + radius);
     setPixel(x0, y0 + radius);
-    setPixel(x0 - radius, y0);
     setPixel(x0, y0 - radius);
 }
 
 void OLEDDisplay::drawCircleQuads(int16_t x0, int16_t y0, int16_t radius, uint8_t quads) {
+    // A radius of 0 still touches the neighbouring pixels
+    int16_t reach = radius > 0 ? radius : 1;
+    if (x0 + reach < clipX0 || x0 - reach >= clipX1 || y0 + reach < clipY0 || y0 - reach >= clipY1) return;
+
+    // Quads 1 and 8 are on the right, 2 and 4 on the left
     int16_t x = 0, y = radius;
     int16_t dp = 1 - radius;
     while (x < y) {
@@ -281,22 +469,10 @@ void OLEDDisplay::drawCircleQuads(int16_t x0, int16_t y0, int16_t radius, uint8_
             dp = dp + (x++) * 2 + 3;
         else
             dp = dp + (x++) * 2 - (y--) * 2 + 5;
-        if (quads & 0x1) {
-            setPixel(x0 + x, y0 - y);
-            setPixel(x0 + y, y0 - x);
-        }
-        if (quads & 0x2) {
-            setPixel(x0 - y, y0 - x);
-            setPixel(x0 - x, y0 - y);
-        }
-        if (quads & 0x4) {
-            setPixel(x0 - y, y0 + x);
-            setPixel(x0 - x, y0 + y);
-        }
-        if (quads & 0x8) {
-            setPixel(x0 + x, y0 + y);
-            setPixel(x0 + y, y0 + x);
-        }
+        setRowPixels(y0 - y, x0 - x, x0 + x, quads & 0x2, quads & 0x1);
+        setRowPixels(y0 - x, x0 - y, x0 + y, quads & 0x2, quads & 0x1);
+        setRowPixels(y0 + x, x0 - y, x0 + y, quads & 0x4, quads & 0x8);
+        setRowPixels(y0 + y, x0 - x, x0 + x, quads & 0x4, quads & 0x8);
     }
     if (quads & 0x1 && quads & 0x8) {
         setPixel(x0 + radius, y0);
@@ -313,6 +489,10 @@ void OLEDDisplay::drawCircleQuads(int16_t x0, int16_t y0, int16_t radius, uint8_
 }
 
 void OLEDDisplay::fillCircle(int16_t x0, int16_t y0, int16_t radius) {
+    // A radius of 0 still touches the neighbouring pixels
+    int16_t reach = radius > 0 ? radius : 1;
+    if (x0 + reach < clipX0 || x0 - reach >= clipX1 || y0 + reach < clipY0 || y0 - reach >= clipY1) return;
+
     int16_t x = 0, y = radius;
     int16_t dp = 1 - radius;
     do {
@@ -333,15 +513,15 @@ void OLEDDisplay::fillCircle(int16_t x0, int16_t y0, int16_t radius) {
 }
 
 void OLEDDisplay::drawHorizontalLine(int16_t x, int16_t y, int16_t length) {
-    if (y < 0 || y >= this->height()) { return; }
+    if (y < clipY0 || y >= clipY1) { return; }
 
-    if (x < 0) {
-        length += x;
-        x = 0;
+    if (x < clipX0) {
+        length -= clipX0 - x;
+        x = clipX0;
     }
 
-    if ((x + length) > this->width()) {
-        length = (this->width() - x);
+    if ((x + length) > clipX1) {
+        length = (clipX1 - x);
     }
 
     if (length <= 0) { return; }
@@ -373,15 +553,15 @@ void OLEDDisplay::drawHorizontalLine(int16_t x, int16_t y, int16_t length) {
 }
 
 void OLEDDisplay::drawVerticalLine(int16_t x, int16_t y, int16_t length) {
-    if (x < 0 || x >= this->width()) return;
+    if (x < clipX0 || x >= clipX1) return;
 
-    if (y < 0) {
-        length += y;
-        y = 0;
+    if (y < clipY0) {
+        length -= clipY0 - y;
+        y = clipY0;
     }
 
-    if ((y + length) > this->height()) {
-        length = (this->height() - y);
+    if ((y + length) > clipY1) {
+        length = (clipY1 - y);
     }
 
     if (length <= 0) return;
@@ -482,6 +662,8 @@ void OLEDDisplay::drawFastImage(int16_t xMove, int16_t yMove, int16_t width, int
 }
 
 void OLEDDisplay::drawXbm(int16_t xMove, int16_t yMove, int16_t width, int16_t height, const uint8_t *xbm) {
+    if (xMove + width <= clipX0 || xMove >= clipX1 || yMove + height <= clipY0 || yMove >= clipY1) return;
+
     int16_t widthInXbm = (width + 7) / 8;
     uint8_t data = 0;
 
@@ -501,6 +683,8 @@ void OLEDDisplay::drawXbm(int16_t xMove, int16_t yMove, int16_t width, int16_t h
 }
 
 void OLEDDisplay::drawIco16x16(int16_t xMove, int16_t yMove, const char *ico, bool inverse) {
+    if (xMove + 16 <= clipX0 || xMove >= clipX1 || yMove + 16 <= clipY0 || yMove >= clipY1) return;
+
     uint16_t data;
 
     for (int16_t y = 0; y < 16; y++) {
@@ -516,6 +700,225 @@ void OLEDDisplay::drawIco16x16(int16_t xMove, int16_t yMove, const char *ico, bo
     }
 }
 
+void OLEDDisplay::setCanvas(OLEDCanvas *canvas) {
+    if (this->canvas == NULL) {
+        displayBuffer = this->buffer;
+        displayBufferWidth = this->displayWidth;
+        displayBufferHeight = this->displayHeight;
+        displayBufferBytes = this->displayBufferSize;
+        displayBufferFirstPage = this->bufferFirstPage;
+        displayClipX0 = clipX0;
+        displayClipY0 = clipY0;
+        displayClipX1 = clipX1;
+        displayClipY1 = clipY1;
+    }
+    this->canvas = canvas;
+
+    this->buffer = canvas->buffer;
+    this->displayWidth = canvas->width();
+    this->displayHeight = canvas->height();
+    this->displayBufferSize = canvas->bufferSize();
+    this->bufferFirstPage = 0;
+    resetClip();
+}
+
+void OLEDDisplay::resetCanvas() {
+    if (this->canvas == NULL) return;
+    this->canvas = NULL;
+
+    this->buffer = displayBuffer;
+    this->displayWidth = displayBufferWidth;
+    this->displayHeight = displayBufferHeight;
+    this->displayBufferSize = displayBufferBytes;
+    this->bufferFirstPage = displayBufferFirstPage;
+    clipX0 = displayClipX0;
+    clipY0 = displayClipY0;
+    clipX1 = displayClipX1;
+    clipY1 = displayClipY1;
+}
+
+bool OLEDDisplay::drawStringToCanvas(OLEDCanvas *canvas, String text) {
+    if (!canvas->allocate(getStringWidth(text), getStringHeight(text))) {
+        return false;
+    }
+
+    OLEDDISPLAY_TEXT_ALIGNMENT savedAlignment = this->textAlignment;
+    OLEDDISPLAY_COLOR savedColor = this->color;
+    OLEDCanvas *savedCanvas = this->canvas;
+
+    setCanvas(canvas);
+    this->textAlignment = TEXT_ALIGN_LEFT;
+    this->color = WHITE;
+    drawString(0, 0, text);
+
+    if (savedCanvas) {
+        setCanvas(savedCanvas);
+    } else {
+        resetCanvas();
+    }
+    this->textAlignment = savedAlignment;
+    this->color = savedColor;
+    return true;
+}
+
+void OLEDDisplay::drawCanvas(int16_t xMove, int16_t yMove, const OLEDCanvas *canvas, bool opaque) {
+    drawCanvas(xMove, yMove, canvas, 0, 0, canvas->width(), canvas->height(), opaque);
+}
+
+void OLEDDisplay::drawCanvas(int16_t xMove, int16_t yMove, const OLEDCanvas *canvas, int16_t srcX, int16_t srcY,
+                             int16_t width, int16_t height, bool opaque) {
+    if (canvas->buffer == NULL || canvas == this->canvas) return;
+
+    // Clip the source rectangle against the canvas
+    if (srcX < 0) { xMove -= srcX; width += srcX; srcX = 0; }
+    if (srcY < 0) { yMove -= srcY; height += srcY; srcY = 0; }
+    if (srcX + width > canvas->width()) width = canvas->width() - srcX;
+    if (srcY + height > canvas->height()) height = canvas->height() - srcY;
+
+    // ... and the destination rectangle against the clip rectangle
+    int16_t xStart = xMove < clipX0 ? clipX0 : xMove;
+    int16_t xEnd = xMove + width > clipX1 ? clipX1 : xMove + width;
+    int16_t yStart = yMove < clipY0 ? clipY0 : yMove;
+    int16_t yEnd = yMove + height > clipY1 ? clipY1 : yMove + height;
+    if (xStart >= xEnd || yStart >= yEnd) return;
+
+    // Destination row y shows source row y - delta
+    int16_t delta = yMove - srcY;
+    int16_t canvasPages = (canvas->height() + 7) >> 3;
+    int16_t columns = xEnd - xStart;
+    const uint8_t *srcColumn = canvas->buffer + xStart - xMove + srcX;
+
+    for (int16_t page = yStart >> 3; page <= (yEnd - 1) >> 3; page++) {
+        // Rows of this page that are covered by the rectangle
+        int16_t pageTop = page << 3;
+        uint8_t mask = 0xFF;
+        if (pageTop < yStart) mask &= 0xFF << (yStart - pageTop);
+        if (pageTop + 8 > yEnd) mask &= 0xFF >> (pageTop + 8 - yEnd);
+
+        // Source rows of this page, split into two source pages
+        int16_t srcRow = pageTop - delta;
+        int16_t srcPage = srcRow >> 3;   // arithmetic shift floors negative rows
+        uint8_t shift = srcRow & 7;
+        const uint8_t *upper = (srcPage >= 0 && srcPage < canvasPages) ? srcColumn + srcPage * canvas->width() : NULL;
+        const uint8_t *lower = (shift && srcPage + 1 >= 0 && srcPage + 1 < canvasPages) ? srcColumn + (srcPage + 1) * canvas->width() : NULL;
+
+        uint8_t *dst = buffer + page * this->width() + xStart;
+
+        for (int16_t x = 0; x < columns; x++) {
+            uint8_t data = 0;
+            if (upper) data = upper[x] >> shift;
+            if (lower) data |= lower[x] << (8 - shift);
+
+            if (opaque) {
+                if (this->color == BLACK) data = ~data;
+                if (this->color == INVERSE) {
+                    dst[x] ^= data & mask;
+                } else {
+                    dst[x] = (dst[x] & ~mask) | (data & mask);
+                }
+                continue;
+            }
+
+            data &= mask;
+            switch (this->color) {
+                case WHITE:   dst[x] |= data; break;
+                case BLACK:   dst[x] &= ~data; break;
+                case INVERSE: dst[x] ^= data; break;
+            }
+        }
+    }
+}
+
+void OLEDDisplay::scrollBuffer(int16_t dx, int16_t dy) {
+    scrollBuffer(dx, dy, clipX0, clipY0, clipX1 - clipX0, clipY1 - clipY0);
+}
+
+void OLEDDisplay::scrollBuffer(int16_t dx, int16_t dy, int16_t xMove, int16_t yMove, int16_t width, int16_t height) {
+    // Clip the rectangle against the clip rectangle
+    int16_t xStart = xMove < clipX0 ? clipX0 : xMove;
+    int16_t xEnd = xMove + width > clipX1 ? clipX1 : xMove + width;
+    int16_t yStart = yMove < clipY0 ? clipY0 : yMove;
+    int16_t yEnd = yMove + height > clipY1 ? clipY1 : yMove + height;
+    if (xStart >= xEnd || yStart >= yEnd) return;
+
+    int16_t firstPage = yStart >> 3;
+    int16_t lastPage = (yEnd - 1) >> 3;
+
+    if (dx != 0) {
+        // Columns that keep content, and the ones that become free
+        int16_t columns = xEnd - xStart - (dx > 0 ? dx : -dx);
+        if (columns < 0) columns = 0;
+        int16_t dstX = dx > 0 ? xEnd - columns : xStart;
+        int16_t srcX = dx > 0 ? xStart : xEnd - columns;
+        int16_t clearX = dx > 0 ? xStart : xStart + columns;
+        int16_t clearColumns = xEnd - xStart - columns;
+
+        for (int16_t page = firstPage; page <= lastPage; page++) {
+            // Rows of this page that are covered by the rectangle
+            int16_t pageTop = page << 3;
+            uint8_t mask = 0xFF;
+            if (pageTop < yStart) mask &= 0xFF << (yStart - pageTop);
+            if (pageTop + 8 > yEnd) mask &= 0xFF >> (pageTop + 8 - yEnd);
+
+            uint8_t *row = buffer + page * this->width();
+            if (mask == 0xFF) {
+                memmove(row + dstX, row + srcX, columns);
+                memset(row + clearX, 0, clearColumns);
+                continue;
+            }
+
+            // Walk away from the destination, so that no column is overwritten before it was moved
+            for (int16_t i = 0; i < columns; i++) {
+                int16_t x = dx > 0 ? columns - 1 - i : i;
+                row[dstX + x] = (row[dstX + x] & ~mask) | (row[srcX + x] & mask);
+            }
+            for (int16_t x = clearX; x < clearX + clearColumns; x++) {
+                row[x] &= ~mask;
+            }
+        }
+    }
+
+    if (dy != 0) {
+        // Moving up the pages are assembled from the top, moving down from the bottom,
+        // so that every source page is read before it is overwritten
+        int16_t columns = xEnd - xStart;
+        for (int16_t i = 0; i <= lastPage - firstPage; i++) {
+            int16_t page = dy < 0 ? firstPage + i : lastPage - i;
+
+            int16_t pageTop = page << 3;
+            uint8_t mask = 0xFF;
+            if (pageTop < yStart) mask &= 0xFF << (yStart - pageTop);
+            if (pageTop + 8 > yEnd) mask &= 0xFF >> (pageTop + 8 - yEnd);
+
+            // Source rows of this page, split into two source pages. Rows that
+            // come from outside of the rectangle are cleared.
+            int16_t srcRow = pageTop - dy;
+            uint8_t srcMask = mask;
+            if (srcRow < yStart) srcMask &= yStart - srcRow < 8 ? 0xFF << (yStart - srcRow) : 0;
+            if (srcRow + 8 > yEnd) srcMask &= srcRow + 8 - yEnd < 8 ? 0xFF >> (srcRow + 8 - yEnd) : 0;
+
+            int16_t srcPage = srcRow >> 3;   // arithmetic shift floors negative rows
+            uint8_t shift = srcRow & 7;
+            uint8_t *dst = buffer + page * this->width() + xStart;
+            const uint8_t *upper = (srcMask && srcPage >= firstPage && srcPage <= lastPage) ? buffer + srcPage * this->width() + xStart : NULL;
+            const uint8_t *lower = (srcMask && shift && srcPage + 1 >= firstPage && srcPage + 1 <= lastPage) ? buffer + (srcPage + 1) * this->width() + xStart : NULL;
+
+            if (mask == 0xFF && srcMask == 0xFF && shift == 0) {
+                // Whole pages can simply be copied
+                memcpy(dst, upper, columns);
+                continue;
+            }
+
+            for (int16_t x = 0; x < columns; x++) {
+                uint8_t data = 0;
+                if (upper) data = upper[x] >> shift;
+                if (lower) data |= lower[x] << (8 - shift);
+                dst[x] = (dst[x] & ~mask) | (data & srcMask);
+            }
+        }
+    }
+}
+
 void OLEDDisplay::drawStringInternal(int16_t xMove, int16_t yMove, char *text, uint16_t textLength, uint16_t textWidth,
                                      short width, short height, short offsetX, short offsetY) {
     uint8_t textHeight = pgm_read_byte(fontData + HEIGHT_POS);
@@ -525,8 +928,8 @@ void OLEDDisplay::drawStringInternal(int16_t xMove, int16_t yMove, char *text, u
     uint16_t cursorX = 0;
 
     // Don't draw anything if it is not on the screen.
-    if (width <= 0 || xMove + offsetX + textWidth < 0 || xMove + offsetX > this->width()) { return; }
-    if (height <= 0 || yMove + offsetY + textHeight < 0 || yMove + offsetY > this->height()) { return; }
+    if (width <= 0 || xMove + offsetX + textWidth < clipX0 || xMove + offsetX > clipX1) { return; }
+    if (height <= 0 || yMove + offsetY + textHeight < clipY0 || yMove + offsetY > clipY1) { return; }
 
     for (uint16_t j = 0; j < textLength; j++) {
         short render_x = xMove + cursorX + offsetX;
@@ -642,30 +1045,97 @@ void OLEDDisplay::drawString(int16_t xMove, int16_t yMove, String strUser, short
     free(text);
 }
 
+// Sine from 0 to 90 degrees in 64 steps, Q16 (the last value is capped to fit)
+static const uint16_t quarterSineQ16[65] PROGMEM = {
+        0,  1608,  3216,  4821,  6424,  8022,  9616, 11204,
+    12785, 14359, 15924, 17479, 19024, 20557, 22078, 23586,
+    25080, 26558, 28020, 29466, 30893, 32303, 33692, 35062,
+    36410, 37736, 39040, 40320, 41576, 42806, 44011, 45190,
+    46341, 47464, 48559, 49624, 50660, 51665, 52639, 53581,
+    54491, 55368, 56212, 57022, 57798, 58538, 59244, 59914,
+    60547, 61145, 61705, 62228, 62714, 63162, 63572, 63944,
+    64277, 64571, 64827, 65043, 65220, 65358, 65457, 65516,
+    65535
+};
+
+uint32_t OLEDDisplay::easeInOutSineQ16(uint32_t t) {
+    if (t >= OLEDDISPLAY_Q16_ONE) return OLEDDISPLAY_Q16_ONE;
+
+    // (1 - cos(PI * t)) / 2 is sin(PI / 2 * t) squared
+    uint16_t index = t >> 10;
+    uint32_t fraction = t & 0x3FF;
+    uint32_t a = pgm_read_word(&quarterSineQ16[index]);
+    uint32_t b = pgm_read_word(&quarterSineQ16[index + 1]);
+    uint32_t sine = a + (((b - a) * fraction) >> 10);
+    return (sine * sine) >> 16;
+}
+
+uint32_t OLEDDisplay::easeOutBounceQ16(uint32_t t) {
+    if (t >= OLEDDISPLAY_Q16_ONE) return OLEDDISPLAY_Q16_ONE;
+
+    // 7.5625 * u * u + offset for the four bounces, the constants are the ones of
+    // easeOutBounce() multiplied by 65536. u is halved to keep u * u in 32 bits.
+    int32_t u;
+    uint32_t offset;
+    if (t < 23831) {            // 1 / 2.75
+        u = t;
+        offset = 0;
+    } else if (t < 47663) {     // 2 / 2.75
+        u = (int32_t) t - 35747;  // 1.5 / 2.75
+        offset = 49152;         // 0.75
+    } else if (t < 59578) {     // 2.5 / 2.75
+        u = (int32_t) t - 53620;  // 2.25 / 2.75
+        offset = 61440;         // 0.9375
+    } else {
+        u = (int32_t) t - 62554;  // 2.625 / 2.75
+        offset = 64512;         // 0.984375
+    }
+    uint32_t half = u < 0 ? -u >> 1 : u >> 1;
+    return ((121 * ((half * half) >> 14)) >> 4) + offset;
+}
+
+uint32_t OLEDDisplay::getEasingProgressQ16(OLEDDISPLAY_EASING_METHOD easing, uint32_t val, uint32_t maxVal) {
+    if (maxVal == 0 || val >= maxVal) return OLEDDISPLAY_Q16_ONE;
+    uint32_t t = ((uint64_t) val << 16) / maxVal;
+
+    switch (easing) {
+        case SINE: return easeInOutSineQ16(t);
+        case BOUNCE: return easeOutBounceQ16(t);
+        default: case LINEAR: return t;
+    }
+}
+
+uint32_t OLEDDisplay::getSpeedQ8(double speed) {
+    if (!(speed > 0)) return 0;     // negative and NaN
+    if (speed >= 65535.0 / 256) return 65535;
+    return speed * 256;
+}
+
+int OLEDDisplay::calculateScrollPosition(int scrollDistance, OLEDDISPLAY_ANIMATION_PROPERTIES properties) {
+    // A string that fits (distance 0 or less) doesn't scroll and stays at the margin,
+    // the easing functions are only defined for a positive distance
+    if (scrollDistance <= 0) return properties.margin;
+
+    // The speed is the only floating point value, everything after its conversion is integer math
+    uint32_t timeVal = (uint64_t) millis() * getSpeedQ8(properties.speed) / (50 * 256);
+    bool forwards = timeVal / (scrollDistance + 1) % 2 == 0;
+
+    uint32_t progress = getEasingProgressQ16(properties.easing, timeVal % (scrollDistance + 1), scrollDistance);
+    int position = (progress * scrollDistance + OLEDDISPLAY_Q16_ONE / 2) >> 16;
+
+    return forwards ? properties.margin - position : properties.margin + position - scrollDistance;
+}
+
 int OLEDDisplay::calculateScrollPositionHorizontal(int renderWidth, String string,
                                                    OLEDDISPLAY_ANIMATION_PROPERTIES properties) {
     int scroll_distance = this->getStringWidth(string) - renderWidth + 2 * properties.margin;
-    long timeVal = millis() * properties.speed / 50;
-    bool moveLeft = timeVal / (scroll_distance + 1) % 2 == 0;
-    int position_x;
-
-    position_x = round(
-            getEasingProgress(properties.easing, timeVal % (scroll_distance + 1), scroll_distance) * scroll_distance);
-
-    return moveLeft ? properties.margin - position_x : properties.margin + position_x - scroll_distance;
+    return calculateScrollPosition(scroll_distance, properties);
 }
 
 int OLEDDisplay::calculateScrollPositionVertical(int renderHeight, String string,
                                                  OLEDDISPLAY_ANIMATION_PROPERTIES properties) {
     int scroll_distance = this->getStringHeight(string) - renderHeight + 2 * properties.margin;
-    long timeVal = millis() * properties.speed / 50;
-    bool moveUp = timeVal / (scroll_distance + 1) % 2 == 0;
-    int position_y;
-
-    position_y = round(
-            getEasingProgress(properties.easing, timeVal % (scroll_distance + 1), scroll_distance) * scroll_distance);
-
-    return moveUp ? properties.margin - position_y : properties.margin + position_y - scroll_distance;
+    return calculateScrollPosition(scroll_distance, properties);
 }
 
 void OLEDDisplay::drawStringHorizontalScrolling(int16_t xMove, int16_t yMove, String strUser, short width, short height,
@@ -780,31 +1250,31 @@ void OLEDDisplay::setFont(const uint8_t *fontData) {
 }
 
 void OLEDDisplay::displayOn(void) {
-    sendCommand(DISPLAYON);
+    broadcastCommand(DISPLAYON);
 }
 
 void OLEDDisplay::displayOff(void) {
-    sendCommand(DISPLAYOFF);
+    broadcastCommand(DISPLAYOFF);
 }
 
 void OLEDDisplay::invertDisplay(void) {
-    sendCommand(INVERTDISPLAY);
+    broadcastCommand(INVERTDISPLAY);
 }
 
 void OLEDDisplay::normalDisplay(void) {
-    sendCommand(NORMALDISPLAY);
+    broadcastCommand(NORMALDISPLAY);
 }
 
 void OLEDDisplay::setContrast(uint8_t contrast, uint8_t precharge, uint8_t comdetect) {
-    sendCommand(SETPRECHARGE); //0xD9
-    sendCommand(precharge); //0xF1 default, to lower the contrast, put 1-1F
-    sendCommand(SETCONTRAST);
-    sendCommand(contrast); // 0-255
-    sendCommand(SETVCOMDETECT); //0xDB, (additionally needed to lower the contrast)
-    sendCommand(comdetect);    //0x40 default, to lower the contrast, put 0
-    sendCommand(DISPLAYALLON_RESUME);
-    sendCommand(NORMALDISPLAY);
-    sendCommand(DISPLAYON);
+    broadcastCommand(SETPRECHARGE); //0xD9
+    broadcastCommand(precharge); //0xF1 default, to lower the contrast, put 1-1F
+    broadcastCommand(SETCONTRAST);
+    broadcastCommand(contrast); // 0-255
+    broadcastCommand(SETVCOMDETECT); //0xDB, (additionally needed to lower the contrast)
+    broadcastCommand(comdetect);    //0x40 default, to lower the contrast, put 0
+    broadcastCommand(DISPLAYALLON_RESUME);
+    broadcastCommand(NORMALDISPLAY);
+    broadcastCommand(DISPLAYON);
 }
 
 void OLEDDisplay::setBrightness(uint8_t brightness) {
@@ -822,29 +1292,571 @@ void OLEDDisplay::setBrightness(uint8_t brightness) {
 }
 
 void OLEDDisplay::resetOrientation() {
-    sendCommand(SEGREMAP);
-    sendCommand(COMSCANINC);           //Reset screen rotation or mirroring
+    broadcastCommand(SEGREMAP);
+    broadcastCommand(COMSCANINC);           //Reset screen rotation or mirroring
 }
 
 void OLEDDisplay::flipScreenVertically() {
-    sendCommand(SEGREMAP | 0x01);
-    sendCommand(COMSCANDEC);           //Rotate screen 180 Deg
+    broadcastCommand(SEGREMAP | 0x01);
+    broadcastCommand(COMSCANDEC);           //Rotate screen 180 Deg
 }
 
 void OLEDDisplay::mirrorScreen() {
-    sendCommand(SEGREMAP);
-    sendCommand(COMSCANDEC);           //Mirror screen
+    broadcastCommand(SEGREMAP);
+    broadcastCommand(COMSCANDEC);           //Mirror screen
+}
+
+void OLEDDisplay::setRotation(OLEDDISPLAY_ROTATION rotation) {
+    // A rotated strip would need every page of the panel, a rotated
+    // buffer page is 8 columns of the panel
+    if (stripPages > 0 || panelWidth() % 8 != 0) return;
+
+    if (!allocateRotatedPage(rotation)) return;
+
+    resetCanvas();
+    if ((this->rotation == ROTATE_0) != (rotation == ROTATE_0)) {
+        uint16_t width = displayWidth;
+        displayWidth = displayHeight;
+        displayHeight = width;
+    }
+    this->rotation = rotation;
+    resetClip();
+
+    // The content has the wrong layout now, the next display() sends everything
+    if (buffer == NULL) return;
+    clear();
+#ifdef OLEDDISPLAY_DOUBLE_BUFFER
+    if (buffer_back != NULL) {
+        memset(buffer_back, 0xFF, displayBufferSize);
+    }
+#endif
+}
+
+void OLEDDisplay::startHorizontalScroll(OLEDDISPLAY_SCROLL_DIRECTION direction, uint8_t startPage, uint8_t endPage,
+                                        OLEDDISPLAY_SCROLL_INTERVAL interval) {
+    // The scroll setup must not be changed while scrolling
+    stopScroll();
+
+    broadcastCommand(direction == SCROLL_LEFT ? LEFTHORIZONTALSCROLL : RIGHTHORIZONTALSCROLL);
+    broadcastCommand(0x00);
+    broadcastCommand(startPage);
+    broadcastCommand(interval);
+    broadcastCommand(endPage);
+    broadcastCommand(0x00);
+    broadcastCommand(0xFF);
+    broadcastCommand(ACTIVATESCROLL);
+
+    scrollActive = true;
+    scrollStartPage = startPage;
+    scrollEndPage = endPage;
+}
+
+void OLEDDisplay::startDiagonalScroll(OLEDDISPLAY_SCROLL_DIRECTION direction, uint8_t startPage, uint8_t endPage,
+                                      uint8_t verticalOffset, OLEDDISPLAY_SCROLL_INTERVAL interval,
+                                      uint8_t fixedRows, uint8_t scrollRows) {
+    stopScroll();
+
+    if (scrollRows == 0) scrollRows = panelHeight() - fixedRows;
+
+    broadcastCommand(SETVERTICALSCROLLAREA);
+    broadcastCommand(fixedRows);
+    broadcastCommand(scrollRows);
+
+    broadcastCommand(direction == SCROLL_LEFT ? VERTICALLEFTHORIZONTALSCROLL : VERTICALRIGHTHORIZONTALSCROLL);
+    broadcastCommand(0x00);
+    broadcastCommand(startPage);
+    broadcastCommand(interval);
+    broadcastCommand(endPage);
+    broadcastCommand(verticalOffset);
+    broadcastCommand(ACTIVATESCROLL);
+
+    // The vertical scrolling moves every page of the scroll area
+    scrollActive = true;
+    scrollStartPage = startPage < fixedRows / 8 ? startPage : fixedRows / 8;
+    scrollEndPage = (fixedRows + scrollRows - 1) / 8;
+    if (endPage > scrollEndPage) scrollEndPage = endPage;
+}
+
+void OLEDDisplay::stopScroll() {
+    if (!scrollActive) return;
+
+    broadcastCommand(DEACTIVATESCROLL);
+    scrollActive = false;
+
+#ifdef OLEDDISPLAY_DOUBLE_BUFFER
+    // The display memory of the scrolled pages is out of sync now,
+    // make sure the next display() sends all of their bytes again
+    if (buffer_back == NULL) return;
+    // The pages are columns of a rotated buffer
+    uint16_t first = rotation == ROTATE_0 ? scrollStartPage * this->width() : 0;
+    uint16_t last = rotation == ROTATE_0 ? (scrollEndPage + 1) * this->width() : displayBufferSize;
+    for (uint16_t i = first; i < last && i < displayBufferSize; i++) {
+        buffer_back[i] = ~buffer[i];
+    }
+#endif
+}
+
+bool OLEDDisplay::scrollStartLine(int8_t pages) {
+    // The pages of a rotated buffer are columns of the panel
+    if (this->height() > OLEDDISPLAY_RAM_PAGES * 8 || rotation != ROTATE_0) return false;
+    if (pages == 0) return true;
+
+    int8_t page = (startLinePage + pages) % OLEDDISPLAY_RAM_PAGES;
+    startLinePage = page < 0 ? page + OLEDDISPLAY_RAM_PAGES : page;
+    broadcastCommand(SETSTARTLINE | (startLinePage * 8));
+
+#ifdef OLEDDISPLAY_DOUBLE_BUFFER
+    // buffer_back holds what the display shows, move it the same way
+    // and mark the pages that scrolled in as changed
+    if (buffer_back == NULL) return true;
+    uint8_t displayPages = this->height() / 8;
+    uint8_t moved = pages > 0 ? pages : -pages;
+    uint16_t pageSize = this->width();
+
+    if (moved >= displayPages) {
+        moved = displayPages;
+    } else if (pages > 0) {
+        memmove(buffer_back, buffer_back + moved * pageSize, (displayPages - moved) * pageSize);
+    } else {
+        memmove(buffer_back + moved * pageSize, buffer_back, (displayPages - moved) * pageSize);
+    }
+
+    uint16_t start = pages > 0 ? (displayPages - moved) * pageSize : 0;
+    for (uint16_t i = start; i < start + moved * pageSize; i++) {
+        buffer_back[i] = ~buffer[i];
+    }
+#endif
+    return true;
+}
+
+void OLEDDisplay::resetStartLine() {
+    startLinePage = 0;
+    broadcastCommand(SETSTARTLINE);
+
+#ifdef OLEDDISPLAY_DOUBLE_BUFFER
+    if (buffer_back == NULL) return;
+    for (uint16_t i = 0; i < displayBufferSize; i++) {
+        buffer_back[i] = ~buffer[i];
+    }
+#endif
+}
+
+void OLEDDisplay::display(void) {
+    uint8_t page = 0;
+    uint16_t minBoundX, maxBoundX;
+    uint8_t minBoundY, maxBoundY;
+
+    selectBus();
+    abandonGroupFlush();
+
+    if (rotation != ROTATE_0) {
+        while (sendNextRotatedPage(page));
+        return;
+    }
+
+    while (getNextFlushRegion(page, minBoundX, maxBoundX, minBoundY, maxBoundY)) {
+        sendBuffer(minBoundX, maxBoundX, minBoundY, maxBoundY);
+        if (mirrorCount > 0) sendBufferToMirrors(minBoundX, maxBoundX, minBoundY, maxBoundY);
+    }
+}
+
+bool OLEDDisplay::addMirror(OLEDDisplay *mirror) {
+    if (mirror == NULL || mirror == this || mirrorCount >= OLEDDISPLAY_MAX_MIRRORS) return false;
+    if (mirror->panelWidth() != panelWidth() || mirror->panelHeight() != panelHeight()) return false;
+    // Both would receive the data of each other. Drivers without shared pins (SPI, mbed)
+    // can't tell whether they are on the same bus, they are trusted to be on different ones.
+    uint8_t sda, scl, mirrorSda, mirrorScl;
+    if (this->getBusPins(sda, scl) && mirror->getBusPins(mirrorSda, mirrorScl) && sda == mirrorSda && scl == mirrorScl &&
+        mirror->getBusAddress() == this->getBusAddress()) return false;
+
+    // The mirror shows our buffer, it doesn't need its own
+    mirror->end();
+    if (!mirror->connect()) return false;
+    mirror->sendInitCommands();
+    if (mirrorNeedsBus(mirror)) this->beginBus();
+    mirrors[mirrorCount++] = mirror;
+
+    // The mirror shows nothing yet, the next display() sends everything
+#ifdef OLEDDISPLAY_DOUBLE_BUFFER
+    if (buffer_back != NULL) {
+        for (uint16_t i = 0; i < displayBufferSize; i++) {
+            buffer_back[i] = ~buffer[i];
+        }
+    }
+#endif
+    return true;
+}
+
+void OLEDDisplay::removeMirror(OLEDDisplay *mirror) {
+    for (uint8_t i = 0; i < mirrorCount; i++) {
+        if (mirrors[i] == mirror) {
+            mirrors[i] = mirrors[--mirrorCount];
+            return;
+        }
+    }
+}
+
+bool OLEDDisplay::mirrorNeedsBus(OLEDDisplay *mirror) {
+    uint8_t sda, scl, mirrorSda, mirrorScl;
+    if (!mirror->getBusPins(mirrorSda, mirrorScl)) return false;
+    return !this->getBusPins(sda, scl) || sda != mirrorSda || scl != mirrorScl;
+}
+
+void OLEDDisplay::sendBufferToMirrors(uint16_t minBoundX, uint16_t maxBoundX, uint8_t minBoundY, uint8_t maxBoundY) {
+    bool busMoved = false;
+    for (uint8_t i = 0; i < mirrorCount; i++) {
+        OLEDDisplay *mirror = mirrors[i];
+        if (mirrorNeedsBus(mirror)) {
+            mirror->beginBus();
+            busMoved = true;
+        }
+        // Lend our buffer to the mirror for the time of the transfer
+        mirror->buffer = this->buffer;
+        mirror->bufferLent = true;
+        mirror->startLinePage = this->startLinePage;
+        mirror->sendBuffer(minBoundX, maxBoundX, minBoundY, maxBoundY);
+        mirror->buffer = NULL;
+        mirror->bufferLent = false;
+    }
+    if (busMoved) this->beginBus();
+}
+
+void OLEDDisplay::selectBus() {
+    if (group != NULL) group->selectBus(this);
+}
+
+void OLEDDisplay::abandonGroupFlush() {
+    if (group != NULL) group->abandonFlush(this);
+}
+
+void OLEDDisplay::broadcastCommand(uint8_t com) {
+    selectBus();
+    sendCommand(com);
+    if (mirrorCount == 0) return;
+
+    bool busMoved = false;
+    for (uint8_t i = 0; i < mirrorCount; i++) {
+        if (mirrorNeedsBus(mirrors[i])) {
+            mirrors[i]->beginBus();
+            busMoved = true;
+        }
+        mirrors[i]->sendCommand(com);
+    }
+    if (busMoved) this->beginBus();
+}
+
+// The clocks autoTuneBusClock() tries and the bus errors fall back to
+static const uint32_t busClockSteps[] = {100000, 200000, 400000, 700000, 1000000};
+
+void OLEDDisplay::setBusClock(uint32_t clock) {
+    if (busClock == 0 || clock == 0) return;
+    busClock = clock;
+    busErrorsInRow = 0;
+    applyBusClock();
+}
+
+void OLEDDisplay::busTransferDone(bool ok) {
+    if (ok) {
+        busErrorsInRow = 0;
+        return;
+    }
+    busErrors++;
+    // autoTuneBusClock() looks at the errors itself
+    if (busTuning || ++busErrorsInRow < OLEDDISPLAY_BUS_ERROR_FALLBACK) return;
+
+    busErrorsInRow = 0;
+    for (int8_t i = sizeof(busClockSteps) / sizeof(busClockSteps[0]) - 1; i >= 0; i--) {
+        if (busClockSteps[i] < busClock) {
+            busClock = busClockSteps[i];
+            applyBusClock();
+            return;
+        }
+    }
+}
+
+uint32_t OLEDDisplay::autoTuneBusClock(uint32_t maxClock) {
+    if (busClock == 0) return 0;
+
+    // The bus may be bound to another display, e.g. by a group, a mirror or a tile.
+    // A group has to bind it again for the next display it sends to.
+    beginBus();
+    if (group != NULL) group->boundDisplay = -1;
+
+    // The probes are expected to fail at some point, they don't count as errors of the display
+    uint32_t errors = busErrors;
+    uint32_t good = 0;
+    busTuning = true;
+    for (uint8_t i = 0; i < sizeof(busClockSteps) / sizeof(busClockSteps[0]) && busClockSteps[i] <= maxClock; i++) {
+        busClock = busClockSteps[i];
+        applyBusClock();
+        uint32_t before = busErrors;
+        for (uint8_t probe = 0; probe < OLEDDISPLAY_BUS_TUNE_PROBES && busErrors == before; probe++) {
+            sendCommand(NOOPERATION);
+        }
+        if (busErrors != before) break;
+        good = busClock;
+    }
+    busTuning = false;
+    busErrors = errors;
+    busErrorsInRow = 0;
+
+    busClock = good ? good : busClockSteps[0];
+    applyBusClock();
+    return good;
+}
+
+bool OLEDDisplay::getNextFlushRegion(uint8_t &page, uint16_t &minBoundX, uint16_t &maxBoundX, uint8_t &minBoundY, uint8_t &maxBoundY) {
+    // Only the pages held by the buffer
+    uint8_t pages = bufferFirstPage + displayBufferSize / this->width();
+    if (pages > this->height() / 8) pages = this->height() / 8;
+    if (page < bufferFirstPage) page = bufferFirstPage;
+
+    while (page < pages) {
+        if (isScrolledPage(page)) {
+            page++;
+            continue;
+        }
+
+        // The region ends in front of the next scrolled page
+        // or where it wraps around in the display memory
+        uint8_t lastPage = page;
+        while (!flushPerPage && lastPage + 1 < pages && !isScrolledPage(lastPage + 1) && toRamPage(lastPage + 1) != 0) {
+            lastPage++;
+        }
+
+#ifdef OLEDDISPLAY_DOUBLE_BUFFER
+        // Strips have no back buffer, they are always sent completely
+        if (buffer_back != NULL) {
+            minBoundY = UINT8_MAX;
+            maxBoundY = 0;
+            minBoundX = UINT16_MAX;
+            maxBoundX = 0;
+
+            // Calculate the bounding box of changes
+            // and copy buffer[pos] to buffer_back[pos];
+            for (uint8_t y = page; y <= lastPage; y++) {
+                for (uint16_t x = 0; x < this->width(); x++) {
+                    uint16_t pos = x + y * this->width();
+                    if (buffer[pos] != buffer_back[pos]) {
+                        if (y < minBoundY) minBoundY = y;
+                        if (y > maxBoundY) maxBoundY = y;
+                        if (x < minBoundX) minBoundX = x;
+                        if (x > maxBoundX) maxBoundX = x;
+                    }
+                    buffer_back[pos] = buffer[pos];
+                }
+                yield();
+            }
+
+            page = lastPage + 1;
+
+            // If the minBoundY wasn't updated
+            // we can savely assume that buffer_back[pos] == buffer[pos]
+            // holdes true for all values of pos
+            if (minBoundY != UINT8_MAX) return true;
+            continue;
+        }
+#endif
+        minBoundX = 0;
+        maxBoundX = this->width() - 1;
+        minBoundY = page;
+        maxBoundY = lastPage;
+        page = lastPage + 1;
+        return true;
+    }
+
+    return false;
+}
+
+void OLEDDisplay::invalidateRegion(uint16_t minBoundX, uint16_t maxBoundX, uint8_t minBoundY, uint8_t maxBoundY) {
+#ifdef OLEDDISPLAY_DOUBLE_BUFFER
+    if (buffer_back == NULL) return;
+    for (uint8_t y = minBoundY; y <= maxBoundY; y++) {
+        for (uint16_t x = minBoundX; x <= maxBoundX; x++) {
+            buffer_back[x + y * this->width()] = ~buffer[x + y * this->width()];
+        }
+    }
+#else
+    (void)minBoundX; (void)maxBoundX; (void)minBoundY; (void)maxBoundY;
+#endif
+}
+
+// Transpose a block of 8x8 pixels: bit i of out[j] becomes bit j of in[i]
+static void transposeBlock(const uint8_t *in, int8_t inStep, uint8_t *out, int8_t outStep) {
+    uint32_t x = ((uint32_t) in[7 * inStep] << 24) | ((uint32_t) in[6 * inStep] << 16) | (in[5 * inStep] << 8) | in[4 * inStep];
+    uint32_t y = ((uint32_t) in[3 * inStep] << 24) | ((uint32_t) in[2 * inStep] << 16) | (in[inStep] << 8) | in[0];
+    uint32_t t;
+
+    // Swap the bits of the 2x2, then the 2x2 blocks of the 4x4 and then the 4x4 blocks
+    t = (x ^ (x >> 7)) & 0x00AA00AA;  x = x ^ t ^ (t << 7);
+    t = (y ^ (y >> 7)) & 0x00AA00AA;  y = y ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC; x = x ^ t ^ (t << 14);
+    t = (y ^ (y >> 14)) & 0x0000CCCC; y = y ^ t ^ (t << 14);
+    t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+    y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+    x = t;
+
+    out[7 * outStep] = x >> 24;
+    out[6 * outStep] = x >> 16;
+    out[5 * outStep] = x >> 8;
+    out[4 * outStep] = x;
+    out[3 * outStep] = y >> 24;
+    out[2 * outStep] = y >> 16;
+    out[outStep] = y >> 8;
+    out[0] = y;
+}
+
+uint16_t OLEDDisplay::sendNextRotatedPage(uint8_t &page) {
+    // Every panel page is 8 columns of the buffer and every buffer page 8 columns
+    // of the panel, so a block of 8 bytes in the buffer is a block of 8 bytes on the panel
+    uint16_t width = panelWidth();
+    uint16_t height = panelHeight();
+    uint8_t blocks = width / 8;
+    if (rotatedPage == NULL) return 0;
+
+    while (page < height / 8) {
+        uint8_t panelPage = page++;
+        if (isScrolledPage(panelPage)) continue;
+
+        // ROTATE_90 shows the first buffer column at the top of the panel, ROTATE_270 the last
+        uint16_t firstColumn = rotation == ROTATE_90 ? panelPage * 8 : displayWidth - 8 - panelPage * 8;
+        uint8_t minBlock = UINT8_MAX;
+        uint8_t maxBlock = 0;
+
+        for (uint8_t block = 0; block < blocks; block++) {
+#ifdef OLEDDISPLAY_DOUBLE_BUFFER
+            if (buffer_back != NULL) {
+                uint16_t pos = firstColumn + block * displayWidth;
+                if (memcmp(buffer + pos, buffer_back + pos, 8) == 0) continue;
+                memcpy(buffer_back + pos, buffer + pos, 8);
+            }
+#endif
+            if (block < minBlock) minBlock = block;
+            maxBlock = block;
+        }
+        if (minBlock == UINT8_MAX) continue;
+
+        // ROTATE_90 shows the first buffer page at the right edge of the panel, ROTATE_270 at the left
+        uint16_t minBoundX = rotation == ROTATE_90 ? width - 8 - maxBlock * 8 : minBlock * 8;
+        uint16_t maxBoundX = minBoundX + (maxBlock - minBlock) * 8 + 7;
+
+        uint8_t *pageData = rotatedPage + getBufferOffset();
+        for (uint8_t block = minBlock; block <= maxBlock; block++) {
+            const uint8_t *blockData = buffer + firstColumn + block * displayWidth;
+            if (rotation == ROTATE_90) {
+                transposeBlock(blockData, 1, pageData + width - 1 - block * 8, -1);
+            } else {
+                transposeBlock(blockData + 7, -1, pageData + block * 8, 1);
+            }
+        }
+        yield();
+
+        // Send it as the buffer of the unrotated panel
+        uint8_t *drawBuffer = buffer;
+        buffer = pageData - panelPage * width;
+        displayWidth = width;
+        displayHeight = height;
+        sendBuffer(minBoundX, maxBoundX, panelPage, panelPage);
+        if (mirrorCount > 0) sendBufferToMirrors(minBoundX, maxBoundX, panelPage, panelPage);
+        displayWidth = height;
+        displayHeight = width;
+        buffer = drawBuffer;
+
+        return maxBoundX - minBoundX + 1;
+    }
+
+    return 0;
 }
 
 void OLEDDisplay::clear(void) {
-    memset(buffer, 0, displayBufferSize);
+    memset(buffer + bufferFirstPage * this->width(), 0, displayBufferSize);
 }
 
-void OLEDDisplay::drawLogBuffer(uint16_t xMove, uint16_t yMove) {
+uint16_t OLEDDisplay::prepareLogBufferLines() {
+    uint16_t lineHeight = pgm_read_byte(fontData + HEIGHT_POS);
+
+    if (logBufferHardwareScroll) {
+        // Lines start at page boundaries, so that the display controller can move them
+        lineHeight = (lineHeight + 7) & ~7;
+        if (logBufferScrolledLines > 0) {
+            uint16_t pages = logBufferScrolledLines * lineHeight / 8;
+            scrollStartLine(pages < this->height() / 8 ? pages : this->height() / 8);
+        }
+    }
+
     // Always align left
     setTextAlignment(TEXT_ALIGN_LEFT);
 
-    drawString(xMove, yMove, String(this->logBuffer));
+    return lineHeight;
+}
+
+void OLEDDisplay::drawLogBufferLine(int16_t xMove, int16_t yMove, uint16_t line) {
+    uint16_t offset = logBufferLineOffset(line);
+    uint16_t length = logBufferLineOffset(line + 1) - offset;
+    // Complete lines end with a line break
+    if (line < this->logBufferLine) length--;
+
+    // A line wrapping around the end of the buffer is drawn in two parts
+    uint16_t start = (this->logBufferStart + offset) % this->logBufferSize;
+    while (length > 0) {
+        uint16_t partLength = length;
+        if (start + partLength > this->logBufferSize) partLength = this->logBufferSize - start;
+        uint16_t textWidth = getStringWidth(&this->logBuffer[start], partLength);
+        drawStringInternal(xMove, yMove, &this->logBuffer[start], partLength, textWidth, this->width(), this->height());
+        xMove += textWidth;
+        length -= partLength;
+        start = 0;
+    }
+}
+
+void OLEDDisplay::drawLogBuffer(uint16_t xMove, uint16_t yMove) {
+    if (this->logBufferSize == 0) return;
+
+    uint16_t lineHeight = prepareLogBufferLines();
+
+    for (uint16_t line = 0; line <= this->logBufferLine; line++) {
+        drawLogBufferLine(xMove, yMove + line * lineHeight, line);
+    }
+
+    logBufferScrolledLines = 0;
+    logBufferChangedLine = this->logBufferMaxLines + 1;
+}
+
+bool OLEDDisplay::drawLogBufferUpdate(uint16_t xMove, uint16_t yMove) {
+    if (this->logBufferSize == 0) return false;
+    if (logBufferScrolledLines == 0 && logBufferChangedLine > this->logBufferLine) return false;
+
+    uint16_t lineHeight = prepareLogBufferLines();
+
+    // Move the lines that are still shown, the rest is redrawn anyway
+    uint16_t firstLine = logBufferChangedLine < this->logBufferLine ? logBufferChangedLine : this->logBufferLine;
+    if (logBufferScrolledLines > 0) {
+        scrollBuffer(0, -(int16_t) (logBufferScrolledLines * lineHeight), xMove, yMove, this->width() - xMove, this->height() - yMove);
+
+        // Lines that didn't fit on the display before come into view now
+        int16_t shownLines = (this->height() - (int16_t) yMove) / lineHeight - logBufferScrolledLines;
+        if (shownLines < 0) shownLines = 0;
+        if (shownLines < firstLine) firstLine = shownLines;
+    }
+
+    OLEDDISPLAY_COLOR color = this->color;
+    this->color = BLACK;
+    fillRect(xMove, yMove + firstLine * lineHeight, this->width() - xMove, this->height());
+    this->color = color;
+
+    for (uint16_t line = firstLine; line <= this->logBufferLine; line++) {
+        drawLogBufferLine(xMove, yMove + line * lineHeight, line);
+    }
+
+    logBufferScrolledLines = 0;
+    logBufferChangedLine = this->logBufferMaxLines + 1;
+    return true;
+}
+
+bool OLEDDisplay::setLogBufferHardwareScroll(bool enable) {
+    this->logBufferHardwareScroll = enable;
+    this->logBufferScrolledLines = 0;
+    return !enable || scrollStartLine(0);
 }
 
 uint16_t OLEDDisplay::getWidth(void) {
@@ -857,21 +1869,57 @@ uint16_t OLEDDisplay::getHeight(void) {
 
 bool OLEDDisplay::setLogBuffer(uint16_t lines, uint16_t chars) {
     if (logBuffer != NULL) free(logBuffer);
+    if (logBufferLineStarts != NULL) free(logBufferLineStarts);
+    this->logBuffer = NULL;
+    this->logBufferLineStarts = NULL;
+    this->logBufferSize = 0;
     uint16_t size = lines * chars;
     if (size > 0) {
         this->logBufferLine = 0;      // Lines printed
         this->logBufferFilled = 0;      // Nothing stored yet
+        this->logBufferStart = 0;
+        this->logBufferFirstLine = 0;
         this->logBufferMaxLines = lines;  // Lines max printable
-        this->logBufferSize = size;   // Total number of characters the buffer can hold
         this->logBuffer = (char *) malloc(size * sizeof(uint8_t));
-        if (!this->logBuffer) {
+        this->logBufferLineStarts = (uint16_t *) malloc((lines + 1) * sizeof(uint16_t));
+        if (!this->logBuffer || !this->logBufferLineStarts) {
             DEBUG_OLEDDISPLAY("[OLEDDISPLAY][setLogBuffer] Not enough memory to create log buffer\n");
             return false;
         }
+        this->logBufferSize = size;   // Total number of characters the buffer can hold
+        this->logBufferLineStarts[0] = 0;
+        this->logBufferScrolledLines = 0;
+        this->logBufferChangedLine = 0;
     }
     return true;
 }
 
+uint16_t OLEDDisplay::logBufferLineOffset(uint16_t line) {
+    if (line > this->logBufferLine) {
+        return this->logBufferFilled;
+    }
+    if (line == 0) {
+        return 0;
+    }
+    uint16_t start = this->logBufferLineStarts[(this->logBufferFirstLine + line) % (this->logBufferMaxLines + 1)];
+    uint16_t offset = (start + this->logBufferSize - this->logBufferStart) % this->logBufferSize;
+    // Only the line after a completely filled buffer can start where the buffer starts
+    return offset > 0 ? offset : this->logBufferSize;
+}
+
+void OLEDDisplay::dropLogBufferLine() {
+    uint16_t offset = logBufferLineOffset(1);
+    this->logBufferFilled -= offset;
+    this->logBufferStart = (this->logBufferStart + offset) % this->logBufferSize;
+    this->logBufferFirstLine = (this->logBufferFirstLine + 1) % (this->logBufferMaxLines + 1);
+    this->logBufferLine--;
+    // More than all lines scrolled out makes no difference
+    if (this->logBufferScrolledLines <= this->logBufferMaxLines) this->logBufferScrolledLines++;
+    if (this->logBufferChangedLine > 0 && this->logBufferChangedLine <= this->logBufferMaxLines) {
+        this->logBufferChangedLine--;
+    }
+}
+
 size_t OLEDDisplay::write(uint8_t c) {
     if (this->logBufferSize > 0) {
         // Don't waste space on \r\n line endings, dropping \r
@@ -882,43 +1930,35 @@ size_t OLEDDisplay::write(uint8_t c) {
         // drop unknown character
         if (c == 0) return 1;
 
-        bool maxLineNotReached = this->logBufferLine < this->logBufferMaxLines;
-        bool bufferNotFull = this->logBufferFilled < this->logBufferSize;
+        // Max line number is reached, drop the first line
+        if (this->logBufferLine >= this->logBufferMaxLines) {
+            dropLogBufferLine();
+        }
 
-        // Can we write to the buffer?
-        if (bufferNotFull && maxLineNotReached) {
-            this->logBuffer[logBufferFilled] = c;
-            this->logBufferFilled++;
-            // Keep track of lines written
-            if (c == 10) this->logBufferLine++;
-        } else {
-            // Max line number is reached
-            if (!maxLineNotReached) this->logBufferLine--;
-
-            // Find the end of the first line
-            uint16_t firstLineEnd = 0;
-            for (uint16_t i = 0; i < this->logBufferFilled; i++) {
-                if (this->logBuffer[i] == 10) {
-                    // Include last char too
-                    firstLineEnd = i + 1;
-                    break;
-                }
-            }
-            // If there was a line ending
-            if (firstLineEnd > 0) {
-                // Calculate the new logBufferFilled value
-                this->logBufferFilled = logBufferFilled - firstLineEnd;
-                // Now we move the lines infront of the buffer
-                memcpy(this->logBuffer, &this->logBuffer[firstLineEnd], logBufferFilled);
+        // Make room for the new character
+        while (this->logBufferFilled >= this->logBufferSize) {
+            if (this->logBufferLine > 0) {
+                dropLogBufferLine();
             } else {
-                // Let's reuse the buffer if it was full
-                if (!bufferNotFull) {
-                    this->logBufferFilled = 0;
-                }// else {
-                //  Nothing to do here
-                //}
+                // Let's reuse the buffer if a single line filled it
+                this->logBufferFilled = 0;
+                this->logBufferLineStarts[this->logBufferFirstLine] = this->logBufferStart;
+                this->logBufferScrolledLines = this->logBufferMaxLines + 1;
+                this->logBufferChangedLine = 0;
             }
-            write(c);
+        }
+
+        this->logBuffer[(this->logBufferStart + this->logBufferFilled) % this->logBufferSize] = c;
+        this->logBufferFilled++;
+        // A line break alone doesn't change what is shown
+        if (c != 10 && this->logBufferLine < this->logBufferChangedLine) {
+            this->logBufferChangedLine = this->logBufferLine;
+        }
+        // Keep track of lines written
+        if (c == 10) {
+            this->logBufferLine++;
+            this->logBufferLineStarts[(this->logBufferFirstLine + this->logBufferLine) % (this->logBufferMaxLines + 1)] =
+                (this->logBufferStart + this->logBufferFilled) % this->logBufferSize;
         }
     }
     // We are always writing all uint8_t to the buffer
@@ -972,76 +2012,83 @@ void OLEDDisplay::setGeometry(OLEDDISPLAY_GEOMETRY g, uint16_t width, uint16_t h
             this->displayHeight = height > 0 ? height : 64;
             break;
     }
-    this->displayBufferSize = displayWidth * displayHeight / 8;
+    this->displayBufferSize = displayWidth * (stripPages ? stripPages * 8 : displayHeight) / 8;
+    resetClip();
 }
 
 void OLEDDisplay::sendInitCommands(void) {
     if (geometry == GEOMETRY_RAWMODE)
         return;
-    sendCommand(DISPLAYOFF);
-    sendCommand(SETDISPLAYCLOCKDIV);
-    sendCommand(0xF0); // Increase speed of the display max ~96Hz
-    sendCommand(SETMULTIPLEX);
-    sendCommand(this->height() - 1);
-    sendCommand(SETDISPLAYOFFSET);
-    sendCommand(0x00);
-    sendCommand(SETSTARTLINE);
-    sendCommand(CHARGEPUMP);
-    sendCommand(0x14);
-    sendCommand(MEMORYMODE);
-    sendCommand(0x00);
-    sendCommand(SEGREMAP);
-    sendCommand(COMSCANINC);
-    sendCommand(SETCOMPINS);
+    broadcastCommand(DISPLAYOFF);
+    broadcastCommand(SETDISPLAYCLOCKDIV);
+    broadcastCommand(0xF0); // Increase speed of the display max ~96Hz
+    broadcastCommand(SETMULTIPLEX);
+    broadcastCommand(panelHeight() - 1);
+    broadcastCommand(SETDISPLAYOFFSET);
+    broadcastCommand(0x00);
+    broadcastCommand(SETSTARTLINE);
+    startLinePage = 0;
+    broadcastCommand(CHARGEPUMP);
+    broadcastCommand(0x14);
+    broadcastCommand(MEMORYMODE);
+    broadcastCommand(0x00);
+    broadcastCommand(SEGREMAP);
+    broadcastCommand(COMSCANINC);
+    broadcastCommand(SETCOMPINS);
 
     if (geometry == GEOMETRY_128_64) {
-        sendCommand(0x12);
+        broadcastCommand(0x12);
     } else if (geometry == GEOMETRY_128_32) {
-        sendCommand(0x02);
+        broadcastCommand(0x02);
     }
 
-    sendCommand(SETCONTRAST);
+    broadcastCommand(SETCONTRAST);
 
     if (geometry == GEOMETRY_128_64) {
-        sendCommand(0xCF);
+        broadcastCommand(0xCF);
     } else if (geometry == GEOMETRY_128_32) {
-        sendCommand(0x8F);
+        broadcastCommand(0x8F);
     }
 
-    sendCommand(SETPRECHARGE);
-    sendCommand(0xF1);
-    sendCommand(SETVCOMDETECT); //0xDB, (additionally needed to lower the contrast)
-    sendCommand(0x40);            //0x40 default, to lower the contrast, put 0
-    sendCommand(DISPLAYALLON_RESUME);
-    sendCommand(NORMALDISPLAY);
-    sendCommand(0x2e);            // stop scroll
-    sendCommand(DISPLAYON);
+    broadcastCommand(SETPRECHARGE);
+    broadcastCommand(0xF1);
+    broadcastCommand(SETVCOMDETECT); //0xDB, (additionally needed to lower the contrast)
+    broadcastCommand(0x40);            //0x40 default, to lower the contrast, put 0
+    broadcastCommand(DISPLAYALLON_RESUME);
+    broadcastCommand(NORMALDISPLAY);
+    broadcastCommand(DEACTIVATESCROLL);
+    broadcastCommand(DISPLAYON);
+    scrollActive = false;
 }
 
 void inline OLEDDisplay::drawInternal(int16_t xMove, int16_t yMove, int16_t width, int16_t height,
                                       const uint8_t *data, uint16_t offset, uint16_t bytesInData,
                                       uint16_t xMin, uint16_t yMin, uint16_t xMax, uint16_t yMax) {
     if (width <= 0 || height <= 0) return;
-    if (yMove + height < 0 || yMove > this->height()) return;
-    if (xMove + width < 0 || xMove > this->width()) return;
-
-    if (xMax < 0 || yMax < 0) return;
+    if (yMove + height <= clipY0 || yMove >= clipY1) return;
+    if (xMove + width <= clipX0 || xMove >= clipX1) return;
 
     uint8_t rasterHeight = 1 + ((height - 1) >> 3); // fast ceil(height / 8.0)
     int8_t yOffset = yMove & 7;
+    int16_t firstPage = yMove >> 3; // rounds down for negative values too
 
     bytesInData = bytesInData == 0 ? width * rasterHeight : bytesInData;
 
-    int16_t initYMove = yMove;
-    int8_t initYOffset = yOffset;
+    // Columns inside both the crop and the clip rectangle
+    int16_t xStart = xMin;
+    int16_t xEnd = xMax < width ? xMax : width;
+    if (xMove + xStart < clipX0) xStart = clipX0 - xMove;
+    if (xMove + xEnd > clipX1) xEnd = clipX1 - xMove;
+    if (xStart >= xEnd) return;
 
+    // Rows outside of the crop or the clip rectangle are masked out
     uint8_t cropBytes[rasterHeight];
 
     for(int i=0; i < rasterHeight; i++)
         cropBytes[i] = 0;
 
     for(int p = 0; p < rasterHeight * 8; p++)
-        if(yMin > p || yMax < p)
+        if(yMin > p || yMax < p || yMove + p < clipY0 || yMove + p >= clipY1)
             cropBytes[p/8] |= 1 << (p%8);
 
     for (uint16_t i = 0; i < bytesInData; i++) {
@@ -1049,53 +2096,41 @@ void inline OLEDDisplay::drawInternal(int16_t xMove, int16_t yMove, int16_t widt
         yield(); // we do this on start to avoid skipping yields
         #endif
 
-        uint16_t charX = i / rasterHeight;
-
-        // Reset if next horizontal drawing phase is started.
-        if (i % rasterHeight == 0) {
-            yMove = initYMove;
-            yOffset = initYOffset;
-        }
+        int16_t charX = i / rasterHeight;
+        uint8_t rasterPage = i % rasterHeight;
 
         // skip horizontal pixels that are out of render range
-        if (charX < xMin || charX >= xMax)
+        if (charX < xStart)
             continue;
-
-        uint8_t currentByte = pgm_read_byte(data + offset + i);
-
-        int16_t xPos = xMove + charX;
-        int16_t yPos = ((yMove >> 3) + i % rasterHeight) * this->width();
-
-        int16_t dataPos = xPos + yPos;
-
-        // cancel when buffer limit is reached or rendering off screen
-        if(dataPos >= displayBufferSize || xPos >= this->width())
+        if (charX >= xEnd)
             break;
 
-        if (dataPos < 0 || xPos < 0)
+        uint8_t currentByte = pgm_read_byte(data + offset + i) & ~(cropBytes[rasterPage]);
+        if (!currentByte)
             continue;
 
-        currentByte &= ~(cropBytes[i % rasterHeight]);
+        int16_t dataPos = xMove + charX + (firstPage + rasterPage) * this->width();
 
-        switch (this->color) {
-            case WHITE:   buffer[dataPos] |= currentByte << yOffset; break;
-            case BLACK:   buffer[dataPos] &= ~(currentByte << yOffset); break;
-            case INVERSE: buffer[dataPos] ^= currentByte << yOffset; break;
-        }
+        // The masked rows guarantee that only pages inside of the buffer get bits
+        uint8_t upperBits = currentByte << yOffset;
+        uint8_t lowerBits = yOffset ? currentByte >> (8 - yOffset) : 0;
 
-        if(yOffset < 0){
-            // Prepare for next iteration
-            yMove -= 8;   // move one block up
-            yOffset += 8; // and set new yOffset
-        }
-        else if (dataPos + this->width() < displayBufferSize) {
+        if (upperBits) {
             switch (this->color) {
-                case WHITE:   buffer[dataPos + this->width()] |= currentByte >> (8 - yOffset); break;
-                case BLACK:   buffer[dataPos + this->width()] &= ~(currentByte >> (8 - yOffset)); break;
-                case INVERSE: buffer[dataPos + this->width()] ^= currentByte >> (8 - yOffset); break;
+                case WHITE:   buffer[dataPos] |= upperBits; break;
+                case BLACK:   buffer[dataPos] &= ~upperBits; break;
+                case INVERSE: buffer[dataPos] ^= upperBits; break;
             }
         }
 
+        if (lowerBits) {
+            dataPos += this->width();
+            switch (this->color) {
+                case WHITE:   buffer[dataPos] |= lowerBits; break;
+                case BLACK:   buffer[dataPos] &= ~lowerBits; break;
+                case INVERSE: buffer[dataPos] ^= lowerBits; break;
+            }
+        }
     }
 }
 
@@ -1131,6 +2166,39 @@ void OLEDDisplay::setFontTableLookupFunction(FontTableLookupFunction function) {
     this->fontTableLookupFunction = function;
 }
 
+OLEDCanvas::OLEDCanvas() {
+    buffer = NULL;
+    canvasWidth = 0;
+    canvasHeight = 0;
+}
+
+OLEDCanvas::~OLEDCanvas() {
+    release();
+}
+
+bool OLEDCanvas::allocate(uint16_t width, uint16_t height) {
+    release();
+    if (width == 0 || height == 0) return false;
+
+    this->buffer = (uint8_t *) malloc(width * ((height + 7) >> 3));
+    if (!this->buffer) {
+        DEBUG_OLEDDISPLAY("[OLEDCANVAS][allocate] Not enough memory to create canvas\n");
+        return false;
+    }
+    this->canvasWidth = width;
+    this->canvasHeight = height;
+    memset(this->buffer, 0, bufferSize());
+    return true;
+}
+
+void OLEDCanvas::release() {
+    if (this->buffer) {
+        free(this->buffer);
+        this->buffer = NULL;
+    }
+    this->canvasWidth = 0;
+    this->canvasHeight = 0;
+}
 
 char DefaultFontTableLookup(const uint8_t ch) {
     // UTF-8 to font table index converter
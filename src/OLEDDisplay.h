@@ -39,6 +39,7 @@
 #include <Arduino.h>
 #elif __MBED__
 #define pgm_read_byte(addr)   (*(const unsigned char *)(addr))
+#define pgm_read_word(addr)   (*(const unsigned short *)(addr))
 
 #include <mbed.h>
 #define delay(x)	wait_ms(x)
@@ -78,6 +79,24 @@ private:
 #define OLEDDISPLAY_DOUBLE_BUFFER
 #endif
 
+// Number of displays that can show the content of another one (see addMirror())
+#ifndef OLEDDISPLAY_MAX_MIRRORS
+#define OLEDDISPLAY_MAX_MIRRORS 4
+#endif
+
+// Pages (8 rows each) of the display memory of SSD1306 and SH1106, the start line wraps around after them
+#define OLEDDISPLAY_RAM_PAGES 8
+
+// Failed transfers in a row after which a display falls back to the next lower bus clock
+#ifndef OLEDDISPLAY_BUS_ERROR_FALLBACK
+#define OLEDDISPLAY_BUS_ERROR_FALLBACK 3
+#endif
+
+// Commands autoTuneBusClock() sends at every clock it tries
+#ifndef OLEDDISPLAY_BUS_TUNE_PROBES
+#define OLEDDISPLAY_BUS_TUNE_PROBES 16
+#endif
+
 // Header Values
 #define JUMPTABLE_BYTES 4
 
@@ -104,6 +123,7 @@ private:
 #define EXTERNALVCC 0x1
 #define INVERTDISPLAY 0xA7
 #define MEMORYMODE 0x20
+#define NOOPERATION 0xE3
 #define NORMALDISPLAY 0xA6
 #define PAGEADDR 0x22
 #define SEGREMAP 0xA0
@@ -119,6 +139,13 @@ private:
 #define SETSTARTLINE 0x40
 #define SETVCOMDETECT 0xDB
 #define SWITCHCAPVCC 0x2
+#define RIGHTHORIZONTALSCROLL 0x26
+#define LEFTHORIZONTALSCROLL 0x27
+#define VERTICALRIGHTHORIZONTALSCROLL 0x29
+#define VERTICALLEFTHORIZONTALSCROLL 0x2A
+#define DEACTIVATESCROLL 0x2E
+#define ACTIVATESCROLL 0x2F
+#define SETVERTICALSCROLLAREA 0xA3
 
 #ifndef _swap_int16_t
 #define _swap_int16_t(a, b) { int16_t t = a; a = b; b = t; }
@@ -143,6 +170,33 @@ enum OLEDDISPLAY_GEOMETRY {
   GEOMETRY_RAWMODE,
 };
 
+// Clockwise rotation of the drawing coordinates, see OLEDDisplay::setRotation()
+enum OLEDDISPLAY_ROTATION {
+  ROTATE_0 = 0,
+  ROTATE_90,
+  ROTATE_270
+};
+
+enum OLEDDISPLAY_SCROLL_DIRECTION {
+  SCROLL_LEFT,
+  SCROLL_RIGHT
+};
+
+// Time between two scroll steps in frames, the values are the SSD1306 encoding
+enum OLEDDISPLAY_SCROLL_INTERVAL {
+  SCROLL_2_FRAMES   = 0x07,
+  SCROLL_3_FRAMES   = 0x04,
+  SCROLL_4_FRAMES   = 0x05,
+  SCROLL_5_FRAMES   = 0x00,
+  SCROLL_25_FRAMES  = 0x06,
+  SCROLL_64_FRAMES  = 0x01,
+  SCROLL_128_FRAMES = 0x02,
+  SCROLL_256_FRAMES = 0x03
+};
+
+// 1.0 in the Q16 fixed point format of the easing functions
+#define OLEDDISPLAY_Q16_ONE 65536UL
+
 enum OLEDDISPLAY_EASING_METHOD {
     LINEAR,
     SINE,
@@ -155,11 +209,51 @@ struct OLEDDISPLAY_ANIMATION_PROPERTIES {
     OLEDDISPLAY_EASING_METHOD easing = LINEAR;
 };
 
+// An off-screen bitmap of arbitrary size in the same layout as the display
+// buffer: every byte holds 8 vertical pixels and each page is `width()` bytes long.
+// All drawing functions of OLEDDisplay can target it, see OLEDDisplay::setCanvas()
+class OLEDCanvas {
+  public:
+    OLEDCanvas();
+    ~OLEDCanvas();
+
+    // Allocates a blank canvas of the given size
+    // Returns false if the memory could not be allocated
+    bool allocate(uint16_t width, uint16_t height);
+
+    // Free the memory used by the canvas
+    void release();
+
+    uint16_t width(void) const { return canvasWidth; };
+    uint16_t height(void) const { return canvasHeight; };
+    uint16_t bufferSize(void) const { return canvasWidth * ((canvasHeight + 7) >> 3); };
+
+    // The pixels of the canvas, NULL if it isn't allocated
+    const uint8_t *getBuffer(void) const { return buffer; };
+
+  private:
+    // Draws into the buffer
+    friend class OLEDDisplay;
+
+    uint8_t *buffer;
+    uint16_t canvasWidth;
+    uint16_t canvasHeight;
+
+    // The canvas owns its buffer, copies are not supported
+    OLEDCanvas(const OLEDCanvas &);
+    OLEDCanvas &operator=(const OLEDCanvas &);
+};
+
 
 
 typedef char (*FontTableLookupFunction)(const uint8_t ch);
 char DefaultFontTableLookup(const uint8_t ch);
 
+class OLEDDisplay;
+class OLEDDisplayGroup;
+
+typedef void (*OLEDDisplayDrawCallback)(OLEDDisplay *display);
+
 
 #ifdef ARDUINO
 class OLEDDisplay : public Print  {
@@ -176,6 +270,13 @@ class OLEDDisplay : public Stream {
 	uint16_t width(void) const { return displayWidth; };
 	uint16_t height(void) const { return displayHeight; };
 
+    // The pins (sda << 8 | scl) the displays bound the Wire library to, 0xFFFF if unknown.
+    // Shared by all displays, set it to 0xFFFF when binding Wire to other pins elsewhere.
+    static uint16_t &wireBoundPins() {
+        static uint16_t pins = 0xFFFF;
+        return pins;
+    }
+
 
     static float easeInOutSine(float t, float b, float c, float d) {
         return -c/2 * (cos(PI*t/d) - 1) + b;
@@ -204,6 +305,18 @@ class OLEDDisplay : public Stream {
         }
     }
 
+    // Fixed point versions of the easing functions without any float math.
+    // Progress t and the result are Q16 values, 0 to 65536 (OLEDDISPLAY_Q16_ONE).
+    static uint32_t easeInOutSineQ16(uint32_t t);
+    static uint32_t easeOutBounceQ16(uint32_t t);
+
+    // The eased progress of val out of maxVal as Q16 value
+    static uint32_t getEasingProgressQ16(OLEDDISPLAY_EASING_METHOD easing, uint32_t val, uint32_t maxVal);
+
+    // The speed of animation properties as Q8 value (256 is a speed of 1),
+    // limited to 0 to 65535 so that it can't overflow the integer math
+    static uint32_t getSpeedQ8(double speed);
+
 
     // Use this to resume after a deep sleep without resetting the display (what init() would do).
     // Returns true if connection to the display was established and the buffer allocated, false otherwise.
@@ -216,10 +329,24 @@ class OLEDDisplay : public Stream {
     // Free the memory used by the display
     void end();
 
+    // Only allocate a buffer for the given number of pages (8 rows each) instead of the whole
+    // display, to drive displays that don't fit into the memory. Everything is drawn with
+    // drawStrips() then. Call it before init(), 0 allocates the whole display again.
+    void setStripHeight(uint8_t pages);
+
     // Cycle through the initialization
     void resetDisplay(void);
 
     /* Drawing functions */
+    // Restrict all drawing functions to the given rectangle
+    void setClipRect(int16_t x, int16_t y, int16_t width, int16_t height);
+
+    // Allow drawing on the whole display (or canvas) again
+    void resetClip();
+
+    // Returns the current clip rectangle, already limited to the display (or canvas)
+    void getClipRect(int16_t *x, int16_t *y, int16_t *width, int16_t *height);
+
     // Sets the color of all pixel operations
     void setColor(OLEDDISPLAY_COLOR color);
 
@@ -272,12 +399,36 @@ class OLEDDisplay : public Stream {
     // Draw icon 16x16 xbm format
     void drawIco16x16(int16_t x, int16_t y, const char *ico, bool inverse = false);
 
+    /* Canvas functions */
+
+    // All drawing functions render into the canvas until resetCanvas() is called.
+    // Don't call display() in between.
+    void setCanvas(OLEDCanvas *canvas);
+    void resetCanvas();
+
+    // Allocates the canvas just big enough to hold the text and renders it once
+    bool drawStringToCanvas(OLEDCanvas *canvas, String text);
+
+    // Composite the canvas at the given position. Set pixels are drawn in the current color,
+    // if opaque is true the cleared pixels of the canvas are drawn in the opposite color.
+    void drawCanvas(int16_t x, int16_t y, const OLEDCanvas *canvas, bool opaque = false);
+
+    // Composite the part of the canvas starting at (srcX, srcY) with the given width and height
+    void drawCanvas(int16_t x, int16_t y, const OLEDCanvas *canvas, int16_t srcX, int16_t srcY, int16_t width, int16_t height, bool opaque = false);
+
+    // Move the content of the clip rectangle by dx pixels to the right and dy pixels down
+    // (left and up for negative values). The uncovered area is cleared.
+    void scrollBuffer(int16_t dx, int16_t dy);
+
+    // Move the content of the given rectangle only
+    void scrollBuffer(int16_t dx, int16_t dy, int16_t x, int16_t y, int16_t width, int16_t height);
+
     /* Text functions */
 
     // Draws a string at the given location, cropped to the given width/height parameters
     void drawString(int16_t xMove, int16_t yMove, String strUser, short width = 0, short height = 0, short offsetX = 0, short offsetY = 0);
 
-    //
+    // Draws a string that scrolls back and forth when it doesn't fit into width (height), one that fits is drawn at the margin
     void drawStringHorizontalScrolling(int16_t xMove, int16_t yMove, String strUser, short width = 0, short height = 0, OLEDDISPLAY_ANIMATION_PROPERTIES properties = {});
     void drawStringVerticalScrolling(int16_t xMove, int16_t yMove, String strUser, short width = 0, short height = 0, OLEDDISPLAY_ANIMATION_PROPERTIES properties = {});
 
@@ -338,8 +489,78 @@ class OLEDDisplay : public Stream {
     // Mirror the display (to be used in a mirror or as a projector)
     void mirrorScreen();
 
+    // Rotate the drawing coordinates by 90 or 270 degrees for a display mounted in portrait
+    // orientation, width() and height() are swapped. The buffer is kept in the rotated layout,
+    // so all drawing functions run as fast as without rotation and display() transposes the
+    // changed blocks of 8x8 pixels while sending, through a page of the panel that is allocated for it.
+    // Clears the buffer. Not available in strip mode, for a panel width that is no multiple of 8 or
+    // when that page can't be allocated. scrollStartLine() does nothing while rotated.
+    // Combine ROTATE_90 with flipScreenVertically() for the other direction in hardware.
+    void setRotation(OLEDDISPLAY_ROTATION rotation);
+    OLEDDISPLAY_ROTATION getRotation() { return rotation; };
+
+    // Bus clock (I2C only)
+
+    // Set the clock of the bus in Hz, e.g. lower for long cables. Applied right away if the bus is
+    // bound to this display, otherwise when it is bound the next time. Displays on the same pins
+    // share the clock of the bus, give them the same one. Ignored by drivers without a clock (SPI).
+    void setBusClock(uint32_t clock);
+    // The clock in Hz, 0 for drivers without one. After OLEDDISPLAY_BUS_ERROR_FALLBACK failed
+    // transfers in a row the display falls back to the next lower of 100k, 200k, 400k, 700k and 1M.
+    uint32_t getBusClock() { return busClock; };
+    // The failed transfers (e.g. not acknowledged) since the start
+    uint32_t getBusErrors() { return busErrors; };
+
+    // Try the clocks from 100 kHz up to maxClock and keep the fastest one at which the display
+    // acknowledged OLEDDISPLAY_BUS_TUNE_PROBES commands in a row. Call it after init(),
+    // the bus is left bound to this display.
+    // Returns the clock, 0 if even 100 kHz failed (the display is left at 100 kHz then).
+    uint32_t autoTuneBusClock(uint32_t maxClock = 1000000);
+
+    // Hardware scrolling (SSD1306 only)
+
+    // Let the display controller scroll the pages startPage..endPage horizontally.
+    // The content wraps around and the scrolling costs no bus traffic at all.
+    // display() doesn't touch these pages until stopScroll() is called.
+    virtual void startHorizontalScroll(OLEDDISPLAY_SCROLL_DIRECTION direction, uint8_t startPage, uint8_t endPage,
+                                       OLEDDISPLAY_SCROLL_INTERVAL interval = SCROLL_5_FRAMES);
+
+    // Like startHorizontalScroll() but additionally moves the rows fixedRows..fixedRows+scrollRows-1
+    // up by verticalOffset rows per step. All pages of the vertical scroll area are owned by the scrolling.
+    virtual void startDiagonalScroll(OLEDDISPLAY_SCROLL_DIRECTION direction, uint8_t startPage, uint8_t endPage,
+                                     uint8_t verticalOffset, OLEDDISPLAY_SCROLL_INTERVAL interval = SCROLL_5_FRAMES,
+                                     uint8_t fixedRows = 0, uint8_t scrollRows = 0);
+
+    // Stop the hardware scrolling, the next display() restores the scrolled pages
+    void stopScroll();
+
+    // Hardware vertical scrolling by moving the start line (SSD1306 and SH1106, up to 64 rows)
+
+    // Move the content of the display up by the given number of pages (8 rows each), down for negative values.
+    // The display controller moves the rows that stay visible, so the next display() only has to
+    // send the pages that scrolled in (if the buffer was moved the same way).
+    // Returns false and does nothing for displays taller than the display memory or while rotated.
+    bool scrollStartLine(int8_t pages);
+
+    // Show the display memory from its first row again, the next display() sends everything
+    void resetStartLine();
+
     // Write the buffer to the display memory
-    virtual void display(void) = 0;
+    virtual void display(void);
+
+    // Show the content of this display on another display of the same size as well, e.g. on several
+    // identical panels. The content is drawn and compared once and the changes are sent to all of them,
+    // the mirror needs no buffers (the ones it has are freed) and is initialized here. Display commands
+    // like setContrast() or flipScreenVertically() are sent to the mirrors too.
+    // Returns false if the sizes differ, the mirror has the same address on the same bus, it can't be
+    // connected or OLEDDISPLAY_MAX_MIRRORS are added already.
+    bool addMirror(OLEDDisplay *mirror);
+    void removeMirror(OLEDDisplay *mirror);
+
+    // Clear the buffer, let the callback draw and send the result, once for every strip
+    // set by setStripHeight() from the top to the bottom. The drawing functions only touch
+    // the rows of the current strip. Without strips it is the same as clear(), callback, display().
+    void drawStrips(OLEDDisplayDrawCallback callback);
 
     // Clear the local pixel buffer
     void clear(void);
@@ -354,6 +575,17 @@ class OLEDDisplay : public Stream {
     // Draw the log buffer at position (x, y)
     void drawLogBuffer(uint16_t x, uint16_t y);
 
+    // Draw only the lines of the log buffer that changed since it was drawn the last time
+    // and move the others up. The buffer must still hold that last drawing of the log
+    // at the same position (x, y). Returns false when nothing changed.
+    bool drawLogBufferUpdate(uint16_t x, uint16_t y);
+
+    // Let drawLogBuffer() scroll the display with scrollStartLine() when lines are added
+    // to a full log buffer. Lines are drawn 8 rows apart (rounded up) then.
+    // Only use it when the log buffer covers the whole display. Returns false if the display can't
+    // move its start line (see scrollStartLine()), the log is then drawn without it.
+    bool setLogBufferHardwareScroll(bool enable);
+
     // Get screen geometry
     uint16_t getWidth(void);
     uint16_t getHeight(void);
@@ -376,6 +608,10 @@ class OLEDDisplay : public Stream {
     #endif
 
   protected:
+    // Flushes several displays and binds their bus
+    friend class OLEDDisplayGroup;
+    // Sends parts of its buffer to its panels
+    friend class OLEDDisplayTiled;
 
     OLEDDISPLAY_GEOMETRY geometry;
 
@@ -383,24 +619,122 @@ class OLEDDisplay : public Stream {
     uint16_t  displayHeight;
     uint16_t  displayBufferSize;
 
+    // Pages per strip (0 for a buffer of the whole display) and the first page currently
+    // held by the buffer. The buffer pointer is moved up by that many pages, so that the
+    // drawing functions can address the rows of the strip directly.
+    uint8_t   stripPages;
+    uint8_t   bufferFirstPage;
+
+    // Set while a tiled display or the display this one mirrors lends it a buffer. The
+    // getBufferOffset() bytes of headroom are only reserved in front of our own buffer.
+    bool      bufferLent;
+
+    // Software rotation, the buffer holds the rotated image with width() and height() swapped
+    OLEDDISPLAY_ROTATION rotation;
+
+    // One page of the panel with room for the header of the transfer in front, sendNextRotatedPage()
+    // transposes the buffer into it. Only allocated while rotated.
+    uint8_t  *rotatedPage;
+    // Allocate or free it for the given rotation
+    bool      allocateRotatedPage(OLEDDISPLAY_ROTATION rotation);
+
+    // The size of the panel regardless of the rotation
+    uint16_t panelWidth() { return rotation == ROTATE_0 ? displayWidth : displayHeight; };
+    uint16_t panelHeight() { return rotation == ROTATE_0 ? displayHeight : displayWidth; };
+
     // Set the correct height, width and buffer for the geometry
     void setGeometry(OLEDDISPLAY_GEOMETRY g, uint16_t width = 0, uint16_t height = 0);
 
     OLEDDISPLAY_TEXT_ALIGNMENT   textAlignment;
     OLEDDISPLAY_COLOR            color;
 
+    // Clip rectangle, resolved against the buffer (x1 and y1 are exclusive)
+    int16_t   clipX0;
+    int16_t   clipY0;
+    int16_t   clipX1;
+    int16_t   clipY1;
+
     const uint8_t	 *fontData;
 
-    // State values for logBuffer
+    // The display buffer while rendering into a canvas
+    OLEDCanvas  *canvas;
+    uint8_t     *displayBuffer;
+    uint16_t     displayBufferWidth;
+    uint16_t     displayBufferHeight;
+    uint16_t     displayBufferBytes;
+    uint8_t      displayBufferFirstPage;
+    int16_t      displayClipX0;
+    int16_t      displayClipY0;
+    int16_t      displayClipX1;
+    int16_t      displayClipY1;
+
+    // State values for logBuffer, a ring buffer of characters starting at logBufferStart
     uint16_t   logBufferSize;
     uint16_t   logBufferFilled;
     uint16_t   logBufferLine;
     uint16_t   logBufferMaxLines;
+    uint16_t   logBufferStart;
     char      *logBuffer;
 
+    // Ring buffer of logBufferMaxLines + 1 line start positions in logBuffer,
+    // the oldest line at logBufferFirstLine
+    uint16_t  *logBufferLineStarts;
+    uint16_t   logBufferFirstLine;
+
+    // Lines dropped and the first line changed since the log buffer was drawn
+    uint16_t   logBufferScrolledLines;
+    uint16_t   logBufferChangedLine;
+    bool       logBufferHardwareScroll;
+
+    // Distance of the log lines, moves the start line for dropped lines in hardware scroll mode
+    uint16_t prepareLogBufferLines();
+
+    void drawLogBufferLine(int16_t xMove, int16_t yMove, uint16_t line);
+
+    // Remove the oldest line from the log buffer
+    void dropLogBufferLine();
+
+    // Offset of the given line from logBufferStart, the line after the last one starts at logBufferFilled
+    uint16_t logBufferLineOffset(uint16_t line);
+
 
 	// the header size of the buffer used, e.g. for the SPI command header
 	virtual int getBufferOffset(void) = 0;
+
+    // Send the columns minBoundX..maxBoundX of the pages minBoundY..maxBoundY of the buffer
+    // to the same window of the display memory (low level function)
+    virtual void sendBuffer(uint16_t minBoundX, uint16_t maxBoundX, uint8_t minBoundY, uint8_t maxBoundY) {
+        (void)minBoundX; (void)maxBoundX; (void)minBoundY; (void)maxBoundY;
+    };
+
+    // Find the next window from `page` on that display() has to send. Pages owned by the
+    // hardware scrolling are never part of it. With double buffering only the bounding
+    // box of the changed bytes is returned and buffer_back is updated.
+    bool getNextFlushRegion(uint8_t &page, uint16_t &minBoundX, uint16_t &maxBoundX, uint8_t &minBoundY, uint8_t &maxBoundY);
+
+    // Mark a window returned by getNextFlushRegion() as changed again, e.g. when it wasn't sent completely
+    void invalidateRegion(uint16_t minBoundX, uint16_t maxBoundX, uint8_t minBoundY, uint8_t maxBoundY);
+
+    // Used instead of getNextFlushRegion() while rotated: transpose the changed blocks of the
+    // next panel page from `page` on and send them. Returns the number of bytes sent, 0 when done.
+    uint16_t sendNextRotatedPage(uint8_t &page);
+
+    // Set by drivers that address every page on its own anyway (SH1106): the flush
+    // regions are single pages with the changed columns of just that page
+    bool      flushPerPage;
+
+    // Pages owned by the hardware scrolling
+    bool      scrollActive;
+    uint8_t   scrollStartPage;
+    uint8_t   scrollEndPage;
+
+    bool isScrolledPage(uint8_t page) { return scrollActive && page >= scrollStartPage && page <= scrollEndPage; };
+
+    // The page of the display memory shown at the top of the display (see scrollStartLine)
+    uint8_t   startLinePage;
+
+    // The page of the display memory that holds the given page of the buffer
+    uint8_t toRamPage(uint8_t page) { return startLinePage ? (page + startLinePage) % OLEDDISPLAY_RAM_PAGES : page; };
 	
     // Send a command to the display (low level function)
     virtual void sendCommand(uint8_t com) {(void)com;};
@@ -408,18 +742,70 @@ class OLEDDisplay : public Stream {
     // Connect to the display
     virtual bool connect() { return false; };
 
+    // The pins and address of the bus the display is connected to, used by OLEDDisplayGroup.
+    // Returns false if there are no pins that other displays could share (e.g. SPI).
+    virtual bool getBusPins(uint8_t &sda, uint8_t &scl) { (void)sda; (void)scl; return false; };
+    virtual uint8_t getBusAddress() { return 0; };
+
+    // Bind the bus to the pins of this display
+    virtual void beginBus() {};
+
+    // The group the display was added to (see OLEDDisplayGroup), NULL if none
+    OLEDDisplayGroup *group;
+
+    // Let the group bind the bus to this display before commands or a flush outside of the group
+    void selectBus();
+
+    // Before a flush outside of the group: a flush of the group that is in progress
+    // would skip what is sent now, let it mark the rest of its window as changed
+    void abandonGroupFlush();
+
+    // Bus clock in Hz (0 if the driver has none) and the failed transfers
+    uint32_t  busClock;
+    uint32_t  busErrors;
+    uint8_t   busErrorsInRow;
+    bool      busTuning;
+
+    // Set the bus to busClock if it is bound to this display
+    virtual void applyBusClock() {};
+
+    // Called by the drivers with the result of each transfer, falls back to the
+    // next lower clock after OLEDDISPLAY_BUS_ERROR_FALLBACK errors in a row
+    void busTransferDone(bool ok);
+
+    // Displays that show the content of this one (see addMirror())
+    OLEDDisplay *mirrors[OLEDDISPLAY_MAX_MIRRORS];
+    uint8_t     mirrorCount;
+
+    // True if the mirror is on other pins than this display
+    bool mirrorNeedsBus(OLEDDisplay *mirror);
+
+    // Send the window of the buffer to all mirrors
+    void sendBufferToMirrors(uint16_t minBoundX, uint16_t maxBoundX, uint8_t minBoundY, uint8_t maxBoundY);
+
+    // Send a command to the display and its mirrors
+    void broadcastCommand(uint8_t com);
+
     // Send all the init commands
     void sendInitCommands();
 
     // converts utf8 characters to extended ascii
     char* utf8ascii(String s);
 
+    // Set a pixel in the current color that is known to be inside the clip rectangle
+    void inline setPixelUnchecked(int16_t x, int16_t y) __attribute__((always_inline));
+
+    // Set the pixels at xLeft (if left) and xRight (if right) on row y, the row is checked against the
+    // clip rectangle once for both. Used for the symmetric points of circles.
+    void inline setRowPixels(int16_t y, int16_t xLeft, int16_t xRight, bool left = true, bool right = true) __attribute__((always_inline));
+
     void inline drawInternal(int16_t xMove, int16_t yMove, int16_t width, int16_t height, const uint8_t *data, uint16_t offset, uint16_t bytesInData, uint16_t xMin = 0, uint16_t yMin = 0, uint16_t xMax = 0, uint16_t yMax = 0) __attribute__((always_inline));
 
     void drawStringInternal(int16_t xMove, int16_t yMove, char* text, uint16_t textLength, uint16_t textWidth, short width = 0, short height = 0, short offsetX = 0, short offsetY = 0);
 
     int calculateScrollPositionHorizontal(int renderWidth, String string, OLEDDISPLAY_ANIMATION_PROPERTIES properties = {});
     int calculateScrollPositionVertical(int renderHeight, String string, OLEDDISPLAY_ANIMATION_PROPERTIES properties = {});
+    int calculateScrollPosition(int scrollDistance, OLEDDISPLAY_ANIMATION_PROPERTIES properties);
 	
 	FontTableLookupFunction fontTableLookupFunction;
 };
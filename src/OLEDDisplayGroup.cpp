@@ -0,0 +1,268 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018 by ThingPulse, Daniel Eichhorn
+ * Copyright (c) 2018 by Fabrice Weinberg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ThingPulse invests considerable time and money to develop these open source libraries.
+ * Please support us by buying our products (and not the clones) from
+ * https://thingpulse.com
+ *
+ */
+
+#include "OLEDDisplayGroup.h"
+
+OLEDDisplayGroup::OLEDDisplayGroup() {
+  displayCount = 0;
+  chunkPages = 1;
+  flushing = false;
+  nextDisplay = 0;
+  boundDisplay = -1;
+  resetStats();
+}
+
+OLEDDisplayGroup::~OLEDDisplayGroup() {
+  for (uint8_t i = 0; i < this->displayCount; i++) {
+    this->displays[i]->group = NULL;
+  }
+}
+
+bool OLEDDisplayGroup::samePins(OLEDDisplay *a, OLEDDisplay *b) {
+  uint8_t sdaA, sclA, sdaB, sclB;
+  if (!a->getBusPins(sdaA, sclA) || !b->getBusPins(sdaB, sclB)) return false;
+  return sdaA == sdaB && sclA == sclB;
+}
+
+bool OLEDDisplayGroup::add(OLEDDisplay *display) {
+  if (display == NULL || display->group != NULL || this->displayCount >= OLEDDISPLAYGROUP_MAX_DISPLAYS) return false;
+
+  // Keep the displays on the same pins together, behind the last one
+  uint8_t index = this->displayCount;
+  for (uint8_t i = 0; i < this->displayCount; i++) {
+    if (samePins(this->displays[i], display)) {
+      // Both would receive the data of each other
+      if (this->displays[i]->getBusAddress() == display->getBusAddress()) return false;
+      index = i + 1;
+    }
+  }
+
+  for (uint8_t i = this->displayCount; i > index; i--) {
+    this->displays[i] = this->displays[i - 1];
+  }
+  // The indices change, start over
+  abandonFlush();
+  this->displays[index] = display;
+  this->displayCount++;
+  display->group = this;
+
+  this->boundDisplay = -1;
+  return true;
+}
+
+bool OLEDDisplayGroup::remove(OLEDDisplay *display) {
+  int8_t index = indexOf(display);
+  if (index < 0) return false;
+
+  abandonFlush();
+  this->displayCount--;
+  for (uint8_t i = index; i < this->displayCount; i++) {
+    this->displays[i] = this->displays[i + 1];
+  }
+  display->group = NULL;
+
+  this->boundDisplay = -1;
+  return true;
+}
+
+int8_t OLEDDisplayGroup::indexOf(OLEDDisplay *display) {
+  for (uint8_t i = 0; i < this->displayCount; i++) {
+    if (this->displays[i] == display) return i;
+  }
+  return -1;
+}
+
+void OLEDDisplayGroup::abandonFlush(uint8_t index) {
+  FlushState &state = this->flushStates[index];
+  if (this->flushing && state.pending) {
+    this->displays[index]->invalidateRegion(state.minBoundX, state.maxBoundX, state.minBoundY, state.maxBoundY);
+  }
+  state.pending = false;
+  // The rest of the display is compared again by its own flush
+  state.page = UINT8_MAX;
+}
+
+void OLEDDisplayGroup::abandonFlush(OLEDDisplay *display) {
+  int8_t index = indexOf(display);
+  if (index >= 0) abandonFlush(index);
+}
+
+void OLEDDisplayGroup::abandonFlush() {
+  for (uint8_t i = 0; i < this->displayCount; i++) {
+    abandonFlush(i);
+  }
+  this->flushing = false;
+}
+
+uint8_t OLEDDisplayGroup::getDisplayCount() {
+  return this->displayCount;
+}
+
+OLEDDisplay *OLEDDisplayGroup::getDisplay(uint8_t index) {
+  return index < this->displayCount ? this->displays[index] : NULL;
+}
+
+bool OLEDDisplayGroup::init() {
+  bool success = true;
+  for (uint8_t i = 0; i < this->displayCount; i++) {
+    // Connecting binds the bus
+    this->boundDisplay = i;
+    success &= this->displays[i]->init();
+  }
+  return success;
+}
+
+void OLEDDisplayGroup::setChunkPages(uint8_t pages) {
+  this->chunkPages = pages;
+}
+
+void OLEDDisplayGroup::selectBus(uint8_t index) {
+  OLEDDisplay *display = this->displays[index];
+  uint8_t sda, scl;
+  if (!display->getBusPins(sda, scl)) return;
+
+  if (this->boundDisplay >= 0 && samePins(this->displays[this->boundDisplay], display)) {
+    if (this->boundDisplay != index) this->stats.busSwitchesSkipped++;
+  } else {
+    display->beginBus();
+    this->stats.busSwitches++;
+  }
+  this->boundDisplay = index;
+}
+
+uint32_t OLEDDisplayGroup::busErrors(OLEDDisplay *display) {
+  uint32_t errors = display->busErrors;
+  for (uint8_t i = 0; i < display->mirrorCount; i++) {
+    errors += display->mirrors[i]->busErrors;
+  }
+  return errors;
+}
+
+void OLEDDisplayGroup::selectBus(OLEDDisplay *display) {
+  int8_t index = indexOf(display);
+  if (index >= 0) selectBus(index);
+}
+
+bool OLEDDisplayGroup::sendNextChunk(uint8_t index) {
+  OLEDDisplay *display = this->displays[index];
+  FlushState &state = this->flushStates[index];
+  uint32_t errors = busErrors(display);
+
+  if (display->rotation != ROTATE_0) {
+    // The pages of a rotated display are transposed and sent one at a time
+    selectBus(index);
+    uint16_t bytes = 0;
+    for (uint8_t i = 0; i < this->chunkPages || this->chunkPages == 0; i++) {
+      uint16_t sent = display->sendNextRotatedPage(state.page);
+      if (sent == 0) break;
+      bytes += sent;
+    }
+    if (bytes == 0) return false;
+    this->stats.chunks++;
+    this->stats.busErrors += busErrors(display) - errors;
+    this->stats.bytes += (uint32_t) bytes * (1 + display->mirrorCount);
+    return true;
+  }
+
+  if (!state.pending) {
+    if (!display->getNextFlushRegion(state.page, state.minBoundX, state.maxBoundX, state.minBoundY, state.maxBoundY)) {
+      return false;
+    }
+    state.pending = true;
+  }
+
+  uint8_t maxBoundY = state.maxBoundY;
+  if (this->chunkPages > 0 && state.maxBoundY - state.minBoundY >= this->chunkPages) {
+    maxBoundY = state.minBoundY + this->chunkPages - 1;
+  }
+
+  selectBus(index);
+  display->sendBuffer(state.minBoundX, state.maxBoundX, state.minBoundY, maxBoundY);
+  if (display->mirrorCount > 0) {
+    display->sendBufferToMirrors(state.minBoundX, state.maxBoundX, state.minBoundY, maxBoundY);
+  }
+  this->stats.chunks++;
+  this->stats.busErrors += busErrors(display) - errors;
+  this->stats.bytes += (uint32_t) (state.maxBoundX - state.minBoundX + 1) * (maxBoundY - state.minBoundY + 1) * (1 + display->mirrorCount);
+
+  if (maxBoundY == state.maxBoundY) {
+    state.pending = false;
+  } else {
+    state.minBoundY = maxBoundY + 1;
+  }
+  return true;
+}
+
+bool OLEDDisplayGroup::displayNext() {
+  if (!this->flushing) {
+    for (uint8_t i = 0; i < this->displayCount; i++) {
+      this->flushStates[i].page = 0;
+      this->flushStates[i].pending = false;
+    }
+    this->flushing = true;
+    this->nextDisplay = 0;
+    // The displays may have been used without the group since the last flush
+    this->boundDisplay = -1;
+    this->stats.flushes++;
+  }
+
+  // Take turns, skip the displays that are done
+  for (uint8_t i = 0; i < this->displayCount; i++) {
+    uint8_t index = this->nextDisplay;
+    this->nextDisplay = (this->nextDisplay + 1) % this->displayCount;
+    if (sendNextChunk(index)) return true;
+  }
+
+  this->flushing = false;
+  return false;
+}
+
+void OLEDDisplayGroup::display() {
+  while (displayNext());
+}
+
+const OLEDDisplayGroupStats &OLEDDisplayGroup::getStats() {
+  // The clocks may have fallen back since the last call
+  this->stats.busClock = 0;
+  for (uint8_t i = 0; i < this->displayCount; i++) {
+    OLEDDisplay *display = this->displays[i];
+    for (int8_t j = -1; j < display->mirrorCount; j++) {
+      uint32_t clock = j < 0 ? display->busClock : display->mirrors[j]->busClock;
+      if (clock != 0 && (this->stats.busClock == 0 || clock < this->stats.busClock)) {
+        this->stats.busClock = clock;
+      }
+    }
+  }
+  return this->stats;
+}
+
+void OLEDDisplayGroup::resetStats() {
+  memset(&this->stats, 0, sizeof(this->stats));
+}
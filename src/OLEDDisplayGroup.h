@@ -0,0 +1,144 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018 by ThingPulse, Daniel Eichhorn
+ * Copyright (c) 2018 by Fabrice Weinberg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ThingPulse invests considerable time and money to develop these open source libraries.
+ * Please support us by buying our products (and not the clones) from
+ * https://thingpulse.com
+ *
+ */
+
+#ifndef OLEDDISPLAYGROUP_h
+#define OLEDDISPLAYGROUP_h
+
+#include "OLEDDisplay.h"
+
+#ifndef OLEDDISPLAYGROUP_MAX_DISPLAYS
+#define OLEDDISPLAYGROUP_MAX_DISPLAYS 8
+#endif
+
+// Combined numbers of all displays of a group since the last resetStats()
+struct OLEDDisplayGroupStats {
+  uint32_t flushes;            // flushes of all displays started
+  uint32_t chunks;             // windows sent to a display
+  uint32_t bytes;              // bytes of the buffers sent
+  uint32_t busSwitches;        // the bus was bound to other pins
+  uint32_t busSwitchesSkipped; // switches to a display on the pins already bound
+  uint32_t busErrors;          // failed transfers while sending (mirrors included)
+  uint32_t busClock;           // the lowest bus clock of the displays and mirrors now, 0 if none has one
+};
+
+// Flushes several displays that share one or more buses. The changes of all
+// displays are sent in chunks of a few pages, taking turns, so that all of them
+// update at the same pace. Displays on the same pins are kept next to each other
+// and the bus is only bound again (e.g. Wire.begin()) when the pins change.
+class OLEDDisplayGroup {
+  private:
+    // Its displays let the group bind the bus for commands, see OLEDDisplay::selectBus()
+    friend class OLEDDisplay;
+
+    // The state of a display during a flush: the next page to look at
+    // and the rest of the window that is being sent
+    struct FlushState {
+      uint8_t   page;
+      bool      pending;
+      uint16_t  minBoundX;
+      uint16_t  maxBoundX;
+      uint8_t   minBoundY;
+      uint8_t   maxBoundY;
+    };
+
+    OLEDDisplay            *displays[OLEDDISPLAYGROUP_MAX_DISPLAYS];
+    FlushState              flushStates[OLEDDISPLAYGROUP_MAX_DISPLAYS];
+    uint8_t                 displayCount;
+
+    uint8_t                 chunkPages;
+    bool                    flushing;
+    uint8_t                 nextDisplay;
+
+    // The display the bus was last bound for, -1 if unknown
+    int8_t                  boundDisplay;
+
+    OLEDDisplayGroupStats   stats;
+
+    bool samePins(OLEDDisplay *a, OLEDDisplay *b);
+    // The failed transfers of the display and its mirrors
+    uint32_t busErrors(OLEDDisplay *display);
+    void selectBus(uint8_t index);
+    void selectBus(OLEDDisplay *display);
+    int8_t indexOf(OLEDDisplay *display);
+    bool sendNextChunk(uint8_t index);
+
+    // getNextFlushRegion() marks a window as sent when it returns it. Mark the part of it that
+    // wasn't sent yet as changed again and stop the flush of the display (or of all displays).
+    void abandonFlush(uint8_t index);
+    void abandonFlush(OLEDDisplay *display);
+    void abandonFlush();
+
+  public:
+    OLEDDisplayGroup();
+    ~OLEDDisplayGroup();
+
+    /**
+     * Add a display to the group. Returns false if the group is full, the display
+     * is in a group already or a display on the same pins uses the same address.
+     * The group binds the bus for the commands and display() of its displays too.
+     */
+    bool add(OLEDDisplay *display);
+
+    /**
+     * Remove a display from the group, what it didn't send of a flush in progress is sent by
+     * its next display(). Displays remove themselves when they are destroyed.
+     */
+    bool remove(OLEDDisplay *display);
+
+    uint8_t getDisplayCount();
+    OLEDDisplay *getDisplay(uint8_t index);
+
+    /**
+     * Initialize all displays, returns false if one of them failed
+     */
+    bool init();
+
+    /**
+     * The number of pages of a display sent before the next display takes its turn,
+     * 0 sends the whole changed window at once. Default is 1.
+     */
+    void setChunkPages(uint8_t pages);
+
+    /**
+     * Send the changes of all displays
+     */
+    void display();
+
+    /**
+     * Send the next chunk only, a new flush is started if none is in progress.
+     * Returns false when all displays are up to date.
+     */
+    bool displayNext();
+
+    const OLEDDisplayGroupStats &getStats();
+    void resetStats();
+};
+
+#endif
@@ -0,0 +1,294 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018 by ThingPulse, Daniel Eichhorn
+ * Copyright (c) 2018 by Fabrice Weinberg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ThingPulse invests considerable time and money to develop these open source libraries.
+ * Please support us by buying our products (and not the clones) from
+ * https://thingpulse.com
+ *
+ */
+
+#ifndef OLEDDisplayTiled_h
+#define OLEDDisplayTiled_h
+
+#include "OLEDDisplay.h"
+
+// A display made of several panels of the same size, e.g. 256x64 from two 128x64
+// panels side by side or 128x128 from two panels stacked. It is drawn like any
+// other display, display() compares every panel on its own and only sends to the
+// panels that changed. The panels need no buffers of their own, they are given
+// the part of the buffer they show while they send it.
+//
+// Hardware scrolling takes the pages of the whole display, but every panel scrolls
+// on its own: content that leaves a panel wraps around to the other edge of the same
+// panel instead of moving on to the next one. The vertical scroll area of
+// startDiagonalScroll() and scrollStartLine() can't cross panels either, with stacked
+// panels startDiagonalScroll() does nothing unless the pages and the scroll area are
+// on one row of panels, and scrollStartLine() isn't available (more than 64 rows).
+class OLEDDisplayTiled : public OLEDDisplay {
+  private:
+      OLEDDisplay       **tiles;
+      uint8_t             columns;
+      uint8_t             rows;
+      uint16_t            tileWidth;
+      uint8_t             tilePages;
+
+      // The panel the bus was last bound for, -1 if unknown
+      int16_t             boundTile;
+
+  public:
+    // `tiles` holds columns * rows panels row by row, starting at the top left
+    OLEDDisplayTiled(OLEDDisplay **tiles, uint8_t columns, uint8_t rows) {
+      this->tiles = tiles;
+      this->columns = columns;
+      this->rows = rows;
+      this->tileWidth = tiles[0]->width();
+      this->tilePages = tiles[0]->height() / 8;
+      this->boundTile = -1;
+      setGeometry(GEOMETRY_RAWMODE, columns * tileWidth, rows * tilePages * 8);
+    }
+
+    void display(void) {
+      abandonGroupFlush();
+#ifdef OLEDDISPLAY_DOUBLE_BUFFER
+      // A rotated buffer is transposed by OLEDDisplay::display() and sent with sendBuffer()
+      if (buffer_back != NULL && rotation == ROTATE_0) {
+        this->boundTile = -1;
+        for (uint8_t i = 0; i < columns * rows; i++) {
+          uint16_t xOffset = (i % columns) * tileWidth;
+          uint8_t pageOffset = (i / columns) * tilePages;
+
+          uint8_t minBoundY = UINT8_MAX;
+          uint8_t maxBoundY = 0;
+          uint16_t minBoundX = UINT16_MAX;
+          uint16_t maxBoundX = 0;
+
+          // Calculate the bounding box of the changes of this panel
+          // and copy buffer[pos] to buffer_back[pos];
+          for (uint8_t y = 0; y < tilePages; y++) {
+            // The scroll commands went to every panel, a window ends in front of a scrolled
+            // page or where it wraps around in the display memory (see scrollStartLine)
+            if (minBoundY != UINT8_MAX && (isScrolledPage(y + pageOffset) || toRamPage(y) == 0)) {
+              flushTile(i, minBoundX, maxBoundX, minBoundY, maxBoundY);
+              minBoundY = UINT8_MAX;
+              maxBoundY = 0;
+              minBoundX = UINT16_MAX;
+              maxBoundX = 0;
+            }
+            if (isScrolledPage(y + pageOffset)) continue;
+
+            uint16_t pos = xOffset + (y + pageOffset) * this->width();
+            for (uint16_t x = 0; x < tileWidth; x++, pos++) {
+              if (buffer[pos] != buffer_back[pos]) {
+                if (y < minBoundY) minBoundY = y;
+                if (y > maxBoundY) maxBoundY = y;
+                if (x < minBoundX) minBoundX = x;
+                if (x > maxBoundX) maxBoundX = x;
+              }
+              buffer_back[pos] = buffer[pos];
+            }
+            yield();
+
+            // Panels that address every page on their own get the changes of each page
+            if (tiles[i]->flushPerPage && minBoundY == y) {
+              flushTile(i, minBoundX, maxBoundX, y, y);
+              minBoundY = UINT8_MAX;
+              maxBoundY = 0;
+              minBoundX = UINT16_MAX;
+              maxBoundX = 0;
+            }
+          }
+
+          if (minBoundY != UINT8_MAX) {
+            flushTile(i, minBoundX, maxBoundX, minBoundY, maxBoundY);
+          }
+        }
+        return;
+      }
+#endif
+      this->boundTile = -1;
+      OLEDDisplay::display();
+    }
+
+    void startHorizontalScroll(OLEDDISPLAY_SCROLL_DIRECTION direction, uint8_t startPage, uint8_t endPage,
+                               OLEDDISPLAY_SCROLL_INTERVAL interval = SCROLL_5_FRAMES) {
+      // Side by side the panels show the same pages
+      if (rows == 1) {
+        OLEDDisplay::startHorizontalScroll(direction, startPage, endPage, interval);
+        return;
+      }
+
+      stopScroll();
+      // Every panel gets the part of the pages it shows, in its own page numbers
+      for (uint8_t i = 0; i < columns * rows; i++) {
+        uint8_t pageOffset = (i / columns) * tilePages;
+        if (endPage < pageOffset || startPage >= pageOffset + tilePages) continue;
+
+        selectTile(i);
+        tiles[i]->startHorizontalScroll(direction,
+                                        startPage > pageOffset ? startPage - pageOffset : 0,
+                                        endPage < pageOffset + tilePages - 1 ? endPage - pageOffset : tilePages - 1,
+                                        interval);
+      }
+      for (uint8_t i = 0; i < mirrorCount; i++) {
+        if (mirrorNeedsBus(mirrors[i])) mirrors[i]->beginBus();
+        mirrors[i]->startHorizontalScroll(direction, startPage, endPage, interval);
+      }
+      this->boundTile = -1;
+
+      scrollActive = true;
+      scrollStartPage = startPage;
+      scrollEndPage = endPage;
+    }
+
+    void startDiagonalScroll(OLEDDISPLAY_SCROLL_DIRECTION direction, uint8_t startPage, uint8_t endPage,
+                             uint8_t verticalOffset, OLEDDISPLAY_SCROLL_INTERVAL interval = SCROLL_5_FRAMES,
+                             uint8_t fixedRows = 0, uint8_t scrollRows = 0) {
+      if (rows == 1) {
+        OLEDDisplay::startDiagonalScroll(direction, startPage, endPage, verticalOffset, interval, fixedRows, scrollRows);
+        return;
+      }
+
+      // The pages and the vertical scroll area must be on the row of panels of startPage
+      uint8_t pageOffset = startPage - startPage % tilePages;
+      uint16_t firstRow = pageOffset * 8;
+      uint16_t endRow = firstRow + tilePages * 8;
+      if (scrollRows == 0) scrollRows = fixedRows < endRow ? endRow - fixedRows : 0;
+      if (endPage >= pageOffset + tilePages || fixedRows < firstRow || scrollRows == 0 || fixedRows + scrollRows > endRow) return;
+
+      stopScroll();
+      for (uint8_t i = 0; i < columns * rows; i++) {
+        if ((i / columns) * tilePages != pageOffset) continue;
+
+        selectTile(i);
+        tiles[i]->startDiagonalScroll(direction, startPage - pageOffset, endPage - pageOffset, verticalOffset,
+                                      interval, fixedRows - firstRow, scrollRows);
+      }
+      for (uint8_t i = 0; i < mirrorCount; i++) {
+        if (mirrorNeedsBus(mirrors[i])) mirrors[i]->beginBus();
+        mirrors[i]->startDiagonalScroll(direction, startPage, endPage, verticalOffset, interval, fixedRows, scrollRows);
+      }
+      this->boundTile = -1;
+
+      // The vertical scrolling moves every page of the scroll area
+      scrollActive = true;
+      scrollStartPage = startPage < fixedRows / 8 ? startPage : fixedRows / 8;
+      scrollEndPage = (fixedRows + scrollRows - 1) / 8;
+      if (endPage > scrollEndPage) scrollEndPage = endPage;
+    }
+
+  private:
+	int getBufferOffset(void) {
+		return 0;
+	}
+
+    bool connect() {
+      for (uint8_t i = 0; i < columns * rows; i++) {
+        // The panels show parts of our buffer
+        tiles[i]->end();
+        if (!tiles[i]->connect()) {
+          return false;
+        }
+        tiles[i]->sendInitCommands();
+      }
+      this->boundTile = -1;
+      return true;
+    }
+
+    // Bind the bus to the pins of the panel if it isn't already
+    void selectTile(uint8_t index) {
+      uint8_t sda, scl, boundSda, boundScl;
+      if (!tiles[index]->getBusPins(sda, scl)) return;
+      if (boundTile >= 0 && tiles[boundTile]->getBusPins(boundSda, boundScl) && sda == boundSda && scl == boundScl) {
+        return;
+      }
+      tiles[index]->beginBus();
+      this->boundTile = index;
+    }
+
+    // Send a window of a panel and the same window of the mirrors, in the coordinates of the panel
+    void flushTile(uint8_t index, uint16_t minBoundX, uint16_t maxBoundX, uint8_t minBoundY, uint8_t maxBoundY) {
+      sendTile(index, minBoundX, maxBoundX, minBoundY, maxBoundY);
+      if (mirrorCount == 0) return;
+
+      uint16_t xOffset = (index % columns) * tileWidth;
+      uint8_t pageOffset = (index / columns) * tilePages;
+      sendBufferToMirrors(minBoundX + xOffset, maxBoundX + xOffset, minBoundY + pageOffset, maxBoundY + pageOffset);
+      // The mirrors may have moved the bus
+      this->boundTile = -1;
+    }
+
+    // Send a window of a panel, in the coordinates of the panel
+    void sendTile(uint8_t index, uint16_t minBoundX, uint16_t maxBoundX, uint8_t minBoundY, uint8_t maxBoundY) {
+      OLEDDisplay *tile = tiles[index];
+      uint16_t xOffset = (index % columns) * tileWidth;
+      uint8_t pageOffset = (index / columns) * tilePages;
+
+      selectTile(index);
+      // The panels show the display memory from the same start line
+      tile->startLinePage = startLinePage;
+      tile->bufferLent = true;
+      if (columns == 1) {
+        // The rows of the panel are the rows of the buffer
+        tile->buffer = buffer + pageOffset * this->width();
+        tile->sendBuffer(minBoundX, maxBoundX, minBoundY, maxBoundY);
+      } else {
+        // The panel steps through its pages by its own width, so it
+        // gets a buffer that puts one page at the right place at a time
+        for (uint8_t y = minBoundY; y <= maxBoundY; y++) {
+          tile->buffer = buffer + xOffset + (y + pageOffset) * this->width() - y * tileWidth;
+          tile->sendBuffer(minBoundX, maxBoundX, y, y);
+        }
+      }
+      tile->buffer = NULL;
+      tile->bufferLent = false;
+    }
+
+    void sendBuffer(uint16_t minBoundX, uint16_t maxBoundX, uint8_t minBoundY, uint8_t maxBoundY) {
+      this->boundTile = -1;
+      for (uint8_t i = 0; i < columns * rows; i++) {
+        uint16_t xOffset = (i % columns) * tileWidth;
+        uint8_t pageOffset = (i / columns) * tilePages;
+        if (maxBoundX < xOffset || minBoundX >= xOffset + tileWidth) continue;
+        if (maxBoundY < pageOffset || minBoundY >= pageOffset + tilePages) continue;
+
+        sendTile(i,
+                 minBoundX > xOffset ? minBoundX - xOffset : 0,
+                 maxBoundX < xOffset + tileWidth - 1 ? maxBoundX - xOffset : tileWidth - 1,
+                 minBoundY > pageOffset ? minBoundY - pageOffset : 0,
+                 maxBoundY < pageOffset + tilePages - 1 ? maxBoundY - pageOffset : tilePages - 1);
+      }
+    }
+
+    // Display commands go to all panels. The bus may have been moved since the
+    // last call, e.g. by the display this one mirrors.
+    void sendCommand(uint8_t com) {
+      this->boundTile = -1;
+      for (uint8_t i = 0; i < columns * rows; i++) {
+        selectTile(i);
+        tiles[i]->sendCommand(com);
+      }
+    }
+};
+
+#endif
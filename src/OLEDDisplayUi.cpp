@@ -48,7 +48,8 @@ OLEDDisplayUi::OLEDDisplayUi(OLEDDisplay *display) {
   inactiveSymbol = ANIMATION_inactiveSymbol;
   frameAnimationDirection   = SLIDE_RIGHT;
   lastTransitionDirection = 1;
-  ticksPerFrame = 151; // ~ 5000ms at 30 FPS
+  timePerFrame = 5000;
+  timePerTransition = 500;
   ticksPerTransition = 15;  // ~  500ms at 30 FPS
   frameCount = 0;
   nextFrameNumber = -1;
@@ -56,8 +57,18 @@ OLEDDisplayUi::OLEDDisplayUi(OLEDDisplay *display) {
   indicatorDrawState = 1;
   loadingDrawFunction = LoadingDrawDefault;
   updateInterval = 33;
+  idleInterval = 0;
+  lastMillis = 0;
+  millisHigh = 0;
+  lastMicros = 0;
+  microsHigh = 0;
+#ifdef __MBED__
+  timer.start();
+#endif
   state.lastUpdate = 0;
   state.ticksSinceLastStateSwitch = 0;
+  state.lastStateSwitch = 0;
+  state.timeSinceLastStateSwitch = 0;
   state.frameState = FIXED;
   state.currentFrame = 0;
   state.frameTransitionDirection = 1;
@@ -66,6 +77,17 @@ OLEDDisplayUi::OLEDDisplayUi(OLEDDisplay *display) {
   state.userData = NULL;
   shouldDrawIndicators = true;
   autoTransition = true;
+  transitionTicks = NULL;
+  updateTransitionTicks();
+  frameCaching = false;
+  liveFrames = NULL;
+  cachedFrames[0] = cachedFrames[1] = -1;
+  redrawOnDemand = false;
+  needsRedraw = true;
+}
+
+OLEDDisplayUi::~OLEDDisplayUi() {
+  free(this->transitionTicks);
 }
 
 void OLEDDisplayUi::init() {
@@ -73,13 +95,16 @@ void OLEDDisplayUi::init() {
 }
 
 void OLEDDisplayUi::setTargetFPS(uint8_t fps){
-  float oldInterval = this->updateInterval;
-  this->updateInterval = ((float) 1.0 / (float) fps) * 1000;
+  // There is no such thing as no updates at all
+  if (fps == 0) fps = 1;
+  this->updateInterval = 1000 / fps;
+
+  this->ticksPerTransition = this->timePerTransition / this->updateInterval;
+  updateTransitionTicks();
+}
 
-  // Calculate new ticksPerFrame
-  float changeRatio = oldInterval / (float) this->updateInterval;
-  this->ticksPerFrame *= changeRatio;
-  this->ticksPerTransition *= changeRatio;
+void OLEDDisplayUi::setIdleFPS(uint8_t fps){
+  this->idleInterval = fps ? 1000 / fps : 0;
 }
 
 // -/------ Automatic controll ------\-
@@ -102,13 +127,16 @@ void OLEDDisplayUi::setAutoTransitionBackwards(){
 // -/------ Transition property setters -------\-
 
 void OLEDDisplayUi::setTimePerFrame(uint16_t time){
-  this->ticksPerFrame = (uint16_t) ( (float) time / (float) updateInterval);
+  this->timePerFrame = time;
 }
 void OLEDDisplayUi::setTimePerTransition(uint16_t time){
-  this->ticksPerTransition = (uint16_t) ( (float) time / (float) updateInterval);
+  this->timePerTransition = time;
+  this->ticksPerTransition = time / updateInterval;
+  updateTransitionTicks();
 }
 void OLEDDisplayUi::setTransitionMethod(OLEDDISPLAY_EASING_METHOD method){
     easing = method;
+    updateTransitionTicks();
 }
 
 // -/------ Customize indicator position and style -------\-
@@ -122,23 +150,29 @@ void OLEDDisplayUi::disableIndicator(){
 
 void OLEDDisplayUi::enableAllIndicators(){
   this->shouldDrawIndicators = true;
+  this->needsRedraw = true;
 }
 
 void OLEDDisplayUi::disableAllIndicators(){
   this->shouldDrawIndicators = false;
+  this->needsRedraw = true;
 }
 
 void OLEDDisplayUi::setIndicatorPosition(IndicatorPosition pos) {
   this->indicatorPosition = pos;
+  this->needsRedraw = true;
 }
 void OLEDDisplayUi::setIndicatorDirection(IndicatorDirection dir) {
   this->indicatorDirection = dir;
+  this->needsRedraw = true;
 }
 void OLEDDisplayUi::setActiveSymbol(const uint8_t* symbol) {
   this->activeSymbol = symbol;
+  this->needsRedraw = true;
 }
 void OLEDDisplayUi::setInactiveSymbol(const uint8_t* symbol) {
   this->inactiveSymbol = symbol;
+  this->needsRedraw = true;
 }
 
 
@@ -152,10 +186,24 @@ void OLEDDisplayUi::setFrames(FrameCallback* frameFunctions, uint8_t frameCount)
   this->resetState();
 }
 
+void OLEDDisplayUi::enableFrameCaching(const bool* liveFrames) {
+  this->frameCaching = true;
+  this->liveFrames = liveFrames;
+  this->cachedFrames[0] = this->cachedFrames[1] = -1;
+}
+
+void OLEDDisplayUi::disableFrameCaching() {
+  this->frameCaching = false;
+  this->frameCache[0].release();
+  this->frameCache[1].release();
+  this->cachedFrames[0] = this->cachedFrames[1] = -1;
+}
+
 // -/----- Overlays ------\-
 void OLEDDisplayUi::setOverlays(OverlayCallback* overlayFunctions, uint8_t overlayCount){
   this->overlayFunctions = overlayFunctions;
   this->overlayCount     = overlayCount;
+  this->needsRedraw = true;
 }
 
 // -/----- Loading Process -----\-
@@ -191,7 +239,7 @@ void OLEDDisplayUi::nextFrame() {
   if (this->state.frameState != IN_TRANSITION) {
     this->state.manuelControll = true;
     this->state.frameState = IN_TRANSITION;
-    this->state.ticksSinceLastStateSwitch = 0;
+    this->restartStateTime();
     this->lastTransitionDirection = this->state.frameTransitionDirection;
     this->state.frameTransitionDirection = 1;
   }
@@ -200,7 +248,7 @@ void OLEDDisplayUi::previousFrame() {
   if (this->state.frameState != IN_TRANSITION) {
     this->state.manuelControll = true;
     this->state.frameState = IN_TRANSITION;
-    this->state.ticksSinceLastStateSwitch = 0;
+    this->restartStateTime();
     this->lastTransitionDirection = this->state.frameTransitionDirection;
     this->state.frameTransitionDirection = -1;
   }
@@ -208,16 +256,17 @@ void OLEDDisplayUi::previousFrame() {
 
 void OLEDDisplayUi::switchToFrame(uint8_t frame) {
   if (frame >= this->frameCount) return;
-  this->state.ticksSinceLastStateSwitch = 0;
+  this->restartStateTime();
   if (frame == this->state.currentFrame) return;
   this->state.frameState = FIXED;
   this->state.currentFrame = frame;
   this->state.isIndicatorDrawen = true;
+  this->needsRedraw = true;
 }
 
 void OLEDDisplayUi::transitionToFrame(uint8_t frame) {
   if (frame >= this->frameCount) return;
-  this->state.ticksSinceLastStateSwitch = 0;
+  this->restartStateTime();
   if (frame == this->state.currentFrame) return;
   this->nextFrameNumber = frame;
   this->lastTransitionDirection = this->state.frameTransitionDirection;
@@ -227,49 +276,116 @@ void OLEDDisplayUi::transitionToFrame(uint8_t frame) {
 }
 
 
+// -/----- Redrawing -----\-
+void OLEDDisplayUi::enableRedrawOnDemand() {
+  this->redrawOnDemand = true;
+  this->needsRedraw = true;
+}
+
+void OLEDDisplayUi::disableRedrawOnDemand() {
+  this->redrawOnDemand = false;
+}
+
+void OLEDDisplayUi::invalidate() {
+  this->needsRedraw = true;
+}
+
 // -/----- State information -----\-
 OLEDDisplayUiState* OLEDDisplayUi::getUiState(){
   return &this->state;
 }
 
-int16_t OLEDDisplayUi::update(){
+uint64_t OLEDDisplayUi::getMillis(){
 #ifdef ARDUINO
-  unsigned long frameStart = millis();
+  uint32_t now = millis();
 #elif __MBED__
-	Timer t;
-	t.start();
-	unsigned long frameStart = t.read_ms();
+  uint32_t now = this->timer.read_ms();
 #else
 #error "Unkown operating system"
 #endif
-  int16_t timeBudget = this->updateInterval - (frameStart - this->state.lastUpdate);
-  if ( timeBudget <= 0) {
-    // Implement frame skipping to ensure time budget is keept
-    if (this->autoTransition && this->state.lastUpdate != 0) this->state.ticksSinceLastStateSwitch += ceil((double)-timeBudget / (double)this->updateInterval);
-
-    this->state.lastUpdate = frameStart;
-    this->tick();
+  if (now < this->lastMillis) {
+    this->millisHigh++;
   }
+  this->lastMillis = now;
+  return ((uint64_t) this->millisHigh << 32) | now;
+}
+
+uint64_t OLEDDisplayUi::getMicros(){
 #ifdef ARDUINO
-  return this->updateInterval - (millis() - frameStart);
+  uint32_t now = micros();
 #elif __MBED__
-  return this->updateInterval - (t.read_ms() - frameStart);
+  uint32_t now = this->timer.read_us();
 #else
 #error "Unkown operating system"
 #endif
+  if (now < this->lastMicros) {
+    this->microsHigh++;
+  }
+  this->lastMicros = now;
+  return ((uint64_t) this->microsHigh << 32) | now;
+}
+
+uint64_t OLEDDisplayUi::getNextDeadline(){
+  uint32_t interval = this->updateInterval;
+  if (this->idleInterval > this->updateInterval && this->state.frameState == FIXED && !this->needsRedraw) {
+    interval = this->idleInterval;
+  }
+  uint64_t deadline = this->state.lastUpdate + interval;
+
+  if (interval != this->updateInterval && this->autoTransition) {
+    // Wake up in time for the next transition
+    uint64_t now = this->getMicros();
+    uint64_t transitionStart = this->state.lastStateSwitch + this->timePerFrame * 1000UL;
+    uint32_t wait = transitionStart > now ? (transitionStart - now + 999) / 1000 : 0;
+    if (this->getMillis() + wait < deadline) {
+      deadline = this->getMillis() + wait;
+    }
+  }
+  return deadline;
+}
+
+int16_t OLEDDisplayUi::update(){
+  uint64_t frameStart = this->getMillis();
+  if (this->state.lastUpdate == 0) {
+    this->state.lastUpdate = frameStart;
+    this->restartStateTime();
+    this->tick();
+  } else if (frameStart >= this->getNextDeadline()) {
+    // Stay on the grid of the update interval, so that a late tick
+    // doesn't delay the following ones
+    this->state.lastUpdate += (frameStart - this->state.lastUpdate) / this->updateInterval * this->updateInterval;
+    this->tick();
+  }
+
+  int64_t remaining = (int64_t) (this->getNextDeadline() - this->getMillis());
+  if (remaining > INT16_MAX) return INT16_MAX;
+  if (remaining < INT16_MIN) return INT16_MIN;
+  return remaining;
 }
 
 
+void OLEDDisplayUi::restartStateTime() {
+  this->state.lastStateSwitch = this->getMicros();
+  this->state.timeSinceLastStateSwitch = 0;
+  this->state.ticksSinceLastStateSwitch = 0;
+}
+
 void OLEDDisplayUi::tick() {
-  this->state.ticksSinceLastStateSwitch++;
+  // The state advances by the time that passed, not by the number of ticks,
+  // so that slow ticks don't slow down the animations.
+  uint64_t elapsed = this->getMicros() - this->state.lastStateSwitch;
+  this->state.timeSinceLastStateSwitch = elapsed < UINT32_MAX ? elapsed : UINT32_MAX;
 
   switch (this->state.frameState) {
     case IN_TRANSITION:
-        if (this->state.ticksSinceLastStateSwitch >= this->ticksPerTransition){
+        if (this->state.timeSinceLastStateSwitch >= this->timePerTransition * 1000UL){
           this->state.frameState = FIXED;
           this->state.currentFrame = getNextFrameNumber();
-          this->state.ticksSinceLastStateSwitch = 0;
+          this->state.lastStateSwitch += this->timePerTransition * 1000UL;
+          this->state.timeSinceLastStateSwitch -= this->timePerTransition * 1000UL;
           this->nextFrameNumber = -1;
+          // The transition ended, show the new frame
+          this->needsRedraw = true;
         }
       break;
     case FIXED:
@@ -278,15 +394,25 @@ void OLEDDisplayUi::tick() {
         this->state.frameTransitionDirection = this->lastTransitionDirection;
         this->state.manuelControll = false;
       }
-      if (this->state.ticksSinceLastStateSwitch >= this->ticksPerFrame){
+      if (this->state.timeSinceLastStateSwitch >= this->timePerFrame * 1000UL){
           if (this->autoTransition){
             this->state.frameState = IN_TRANSITION;
           }
-          this->state.ticksSinceLastStateSwitch = 0;
+          this->state.lastStateSwitch += this->timePerFrame * 1000UL;
+          this->state.timeSinceLastStateSwitch -= this->timePerFrame * 1000UL;
       }
       break;
   }
 
+  uint32_t ticks = this->state.timeSinceLastStateSwitch / (this->updateInterval * 1000UL);
+  this->state.ticksSinceLastStateSwitch = ticks < 0xFFFF ? ticks : 0xFFFF;
+
+  // Nothing to do for a fixed frame that didn't change
+  if (this->redrawOnDemand && this->state.frameState == FIXED && !this->needsRedraw) {
+    return;
+  }
+  this->needsRedraw = false;
+
   this->display->clear();
   this->drawFrame();
   if (shouldDrawIndicators) {
@@ -297,6 +423,8 @@ void OLEDDisplayUi::tick() {
 }
 
 void OLEDDisplayUi::resetState() {
+  this->cachedFrames[0] = this->cachedFrames[1] = -1;
+  this->needsRedraw = true;
   this->state.lastUpdate = 0;
   this->state.ticksSinceLastStateSwitch = 0;
   this->state.frameState = FIXED;
@@ -307,32 +435,32 @@ void OLEDDisplayUi::resetState() {
 void OLEDDisplayUi::drawFrame(){
   switch (this->state.frameState){
      case IN_TRANSITION: {
-       float progress = OLEDDisplay::getEasingProgress(easing, this->state.ticksSinceLastStateSwitch, this->ticksPerTransition);
+       int16_t offset = getTransitionStepAt(this->state.timeSinceLastStateSwitch).frameOffset;
 
        int16_t x = 0, y = 0, x1 = 0, y1 = 0;
        switch(this->frameAnimationDirection){
         case SLIDE_LEFT:
-          x = -this->display->width() * progress;
+          x = -offset;
           y = 0;
           x1 = x + this->display->width();
           y1 = 0;
           break;
         case SLIDE_RIGHT:
-          x = this->display->width() * progress;
+          x = offset;
           y = 0;
           x1 = x - this->display->width();
           y1 = 0;
           break;
         case SLIDE_UP:
           x = 0;
-          y = -this->display->height() * progress;
+          y = -offset;
           x1 = 0;
           y1 = y + this->display->height();
           break;
         case SLIDE_DOWN:
         default:
           x = 0;
-          y = this->display->height() * progress;
+          y = offset;
           x1 = 0;
           y1 = y - this->display->height();
           break;
@@ -347,11 +475,11 @@ void OLEDDisplayUi::drawFrame(){
 
        // Prope each frameFunction for the indicator Drawen state
        this->enableIndicator();
-       (this->frameFunctions[this->state.currentFrame])(this->display, &this->state, x, y);
+       this->drawTransitionFrame(this->state.currentFrame, 0, x, y);
        drawenCurrentFrame = this->state.isIndicatorDrawen;
 
        this->enableIndicator();
-       (this->frameFunctions[this->getNextFrameNumber()])(this->display, &this->state, x1, y1);
+       this->drawTransitionFrame(this->getNextFrameNumber(), 1, x1, y1);
 
        // Build up the indicatorDrawState
        if (drawenCurrentFrame && !this->state.isIndicatorDrawen) {
@@ -372,6 +500,9 @@ void OLEDDisplayUi::drawFrame(){
        break;
      }
      case FIXED:
+      // The frames may change until the next transition
+      this->cachedFrames[0] = this->cachedFrames[1] = -1;
+
       // Always assume that the indicator is drawn!
       // And set indicatorDrawState to "not known yet"
       this->indicatorDrawState = 0;
@@ -381,6 +512,106 @@ void OLEDDisplayUi::drawFrame(){
   }
 }
 
+OLEDDisplayUi::TransitionTick OLEDDisplayUi::getTransitionTick(uint16_t tick) {
+  if (this->transitionTicks != NULL && tick <= this->ticksPerTransition) {
+    return this->transitionTicks[tick];
+  }
+
+  TransitionTick step;
+  if (tick > this->ticksPerTransition) tick = this->ticksPerTransition;
+
+  // Q16 fixed point, 65536 is the end of the transition
+  step.progress = OLEDDisplay::getEasingProgressQ16(easing, tick, this->ticksPerTransition);
+  step.indicatorOffset = this->ticksPerTransition > 0 ? 8 * tick / this->ticksPerTransition : 8;
+  return step;
+}
+
+OLEDDisplayUi::TransitionStep OLEDDisplayUi::getTransitionStepAt(uint32_t time) {
+  uint32_t duration = this->timePerTransition * 1000UL;
+  TransitionTick tick;
+  if (time >= duration) {
+    tick = getTransitionTick(this->ticksPerTransition);
+  } else {
+    // Position in ticks, Q8 fixed point
+    uint32_t position = ((uint64_t) time * this->ticksPerTransition << 8) / duration;
+    uint8_t fraction = position & 0xFF;
+    tick = getTransitionTick(position >> 8);
+    if (fraction != 0) {
+      // Interpolate to the next tick
+      TransitionTick next = getTransitionTick((position >> 8) + 1);
+      tick.progress += ((int64_t) next.progress - tick.progress) * fraction >> 8;
+      tick.indicatorOffset += ((int16_t) next.indicatorOffset - tick.indicatorOffset) * fraction >> 8;
+    }
+  }
+
+  // The distance of the current geometry, it changes with the rotation of the display
+  TransitionStep step;
+  uint16_t distance = this->frameAnimationDirection == SLIDE_LEFT || this->frameAnimationDirection == SLIDE_RIGHT ?
+                      this->display->width() : this->display->height();
+  step.frameOffset = (distance * tick.progress) >> 16;
+  step.indicatorOffset = tick.indicatorOffset;
+  return step;
+}
+
+void OLEDDisplayUi::updateTransitionTicks() {
+  free(this->transitionTicks);
+  this->transitionTicks = NULL;
+
+  // One entry for every tick including the last one
+  TransitionTick *ticks = (TransitionTick *) malloc((this->ticksPerTransition + 1) * sizeof(TransitionTick));
+  if (ticks == NULL) return;
+
+  for (uint16_t tick = 0; tick <= this->ticksPerTransition; tick++) {
+    ticks[tick] = getTransitionTick(tick);
+  }
+  this->transitionTicks = ticks;
+}
+
+bool OLEDDisplayUi::cacheFrame(uint8_t frame, uint8_t slot) {
+  if (this->cachedFrames[slot] == frame) return true;
+
+  OLEDCanvas *canvas = &this->frameCache[slot];
+  // The geometry may have changed with the rotation of the display
+  if ((canvas->getBuffer() == NULL || canvas->width() != this->display->width() || canvas->height() != this->display->height()) &&
+      !canvas->allocate(this->display->width(), this->display->height())) {
+    return false;
+  }
+
+  this->display->setCanvas(canvas);
+  this->display->clear();
+  (this->frameFunctions[frame])(this->display, &this->state, 0, 0);
+  this->display->resetCanvas();
+
+  this->cachedIndicatorDrawen[slot] = this->state.isIndicatorDrawen;
+  this->cachedFrames[slot] = frame;
+  return true;
+}
+
+void OLEDDisplayUi::drawTransitionFrame(uint8_t frame, uint8_t slot, int16_t x, int16_t y) {
+  bool live = this->liveFrames != NULL && this->liveFrames[frame];
+  if (this->frameCaching && !live && cacheFrame(frame, slot)) {
+    this->state.isIndicatorDrawen = this->cachedIndicatorDrawen[slot];
+
+    OLEDDISPLAY_COLOR color = this->display->getColor();
+    this->display->setColor(WHITE);
+    this->display->drawCanvas(x, y, &this->frameCache[slot]);
+    this->display->setColor(color);
+    return;
+  }
+
+  // Each frame is clipped to its part of the screen (within the clip
+  // rectangle of the caller), so that drawing outside of it costs next to nothing
+  int16_t clipX, clipY, clipWidth, clipHeight;
+  this->display->getClipRect(&clipX, &clipY, &clipWidth, &clipHeight);
+  int16_t x0 = x > clipX ? x : clipX;
+  int16_t y0 = y > clipY ? y : clipY;
+  int16_t x1 = x + this->display->width() < clipX + clipWidth ? x + this->display->width() : clipX + clipWidth;
+  int16_t y1 = y + this->display->height() < clipY + clipHeight ? y + this->display->height() : clipY + clipHeight;
+  this->display->setClipRect(x0, y0, x1 - x0, y1 - y0);
+  (this->frameFunctions[frame])(this->display, &this->state, x, y);
+  this->display->setClipRect(clipX, clipY, clipWidth, clipHeight);
+}
+
 void OLEDDisplayUi::drawIndicator() {
 
     // Only draw if the indicator is invisible
@@ -391,7 +622,8 @@ void OLEDDisplayUi::drawIndicator() {
     }
 
     uint8_t posOfHighlightFrame = 0;
-    float indicatorFadeProgress = 0;
+    // How far the indicator has slid out, in pixels
+    uint16_t indicatorFadeOffset = 0;
 
     // if the indicator needs to be slided in we want to
     // highlight the next frame in the transition
@@ -412,11 +644,12 @@ void OLEDDisplayUi::drawIndicator() {
     switch (this->indicatorDrawState) {
       case 1: // Indicator was not drawn in this frame but will be in next
         // Slide IN
-        indicatorFadeProgress = 1 - ((float) this->state.ticksSinceLastStateSwitch / (float) this->ticksPerTransition);
+        indicatorFadeOffset = this->state.timeSinceLastStateSwitch < this->timePerTransition * 1000UL ?
+          getTransitionStepAt(this->timePerTransition * 1000UL - this->state.timeSinceLastStateSwitch).indicatorOffset : 0;
         break;
       case 2: // Indicator was drawn in this frame but not in next
         // Slide OUT
-        indicatorFadeProgress = ((float) this->state.ticksSinceLastStateSwitch / (float) this->ticksPerTransition);
+        indicatorFadeOffset = getTransitionStepAt(this->state.timeSinceLastStateSwitch).indicatorOffset;
         break;
     }
 
@@ -436,20 +669,20 @@ void OLEDDisplayUi::drawIndicator() {
 
       switch (this->indicatorPosition){
         case TOP:
-          y = 0 - (8 * indicatorFadeProgress);
+          y = 0 - indicatorFadeOffset;
           x = (this->display->width() / 2) - frameStartPos + 12 * i;
           break;
         case BOTTOM:
-          y = (this->display->height() - 8) + (8 * indicatorFadeProgress);
+          y = (this->display->height() - 8) + indicatorFadeOffset;
           x = (this->display->width() / 2) - frameStartPos + 12 * i;
           break;
         case RIGHT:
-          x = (this->display->width() - 8) + (8 * indicatorFadeProgress);
+          x = (this->display->width() - 8) + indicatorFadeOffset;
           y = (this->display->height() / 2) - frameStartPos + 2 + 12 * i;
           break;
         case LEFT:
         default:
-          x = 0 - (8 * indicatorFadeProgress);
+          x = 0 - indicatorFadeOffset;
           y = (this->display->height() / 2) - frameStartPos + 2 + indicatorSpacing * i;
           break;
       }
@@ -89,6 +89,11 @@ struct OLEDDisplayUiState {
   uint64_t     lastUpdate;
   uint16_t      ticksSinceLastStateSwitch;
 
+  // Time (see getMicros()) of the last state switch and the
+  // microseconds that passed since then when the tick started
+  uint64_t      lastStateSwitch;
+  uint32_t      timeSinceLastStateSwitch;
+
   FrameState    frameState;
   uint8_t       currentFrame;
 
@@ -114,6 +119,21 @@ typedef void (*LoadingDrawFunction)(OLEDDisplay *display, LoadingStage* stage, u
 
 class OLEDDisplayUi {
   private:
+    // The offsets of one tick of a frame transition
+    struct TransitionStep {
+      // How far the current frame has moved
+      uint16_t frameOffset;
+      // How far the indicator has slid out
+      uint8_t  indicatorOffset;
+    };
+
+    // A tick of a frame transition: the eased progress (Q16 fixed point,
+    // 65536 is the end) and how far the indicator has slid out
+    struct TransitionTick {
+      uint32_t progress;
+      uint8_t  indicatorOffset;
+    };
+
     OLEDDisplay             *display;
 
     // Symbols for the Indicator
@@ -132,7 +152,8 @@ class OLEDDisplayUi {
 
     int8_t              lastTransitionDirection;
 
-    uint16_t            ticksPerFrame; 		// ~ 5000ms at 30 FPS
+    uint16_t            timePerFrame;		// in ms
+    uint16_t            timePerTransition;	// in ms
     uint16_t            ticksPerTransition;	// ~  500ms at 30 FPS
 
     bool                autoTransition;
@@ -162,6 +183,49 @@ class OLEDDisplayUi {
 
     // Bookeeping for update
     uint16_t            updateInterval            = 33;
+    // Interval of a fixed frame that didn't change, 0 to always use updateInterval
+    uint16_t            idleInterval;
+
+    // 64 bit extension of the millisecond clock
+    uint32_t            lastMillis;
+    uint32_t            millisHigh;
+    // and of the microsecond clock
+    uint32_t            lastMicros;
+    uint32_t            microsHigh;
+#ifdef __MBED__
+    Timer               timer;
+#endif
+
+    // The progress of a transition for every tick, so that no easing has to be
+    // calculated while drawing. The offsets in pixels follow from the current
+    // size of the display. NULL if it didn't fit into memory.
+    TransitionTick*     transitionTicks;
+
+    TransitionTick      getTransitionTick(uint16_t tick);
+    // The step `time` microseconds into the transition, between the steps of two ticks
+    TransitionStep      getTransitionStepAt(uint32_t time);
+    void                updateTransitionTicks();
+
+    // Start measuring the time of a new state
+    void                restartStateTime();
+
+    // Images of the current (0) and the next frame (1) during a transition
+    bool                frameCaching;
+    const bool*         liveFrames;
+    OLEDCanvas          frameCache[2];
+    int16_t             cachedFrames[2];
+    bool                cachedIndicatorDrawen[2];
+
+    bool                cacheFrame(uint8_t frame, uint8_t slot);
+    void                drawTransitionFrame(uint8_t frame, uint8_t slot, int16_t x, int16_t y);
+
+    // Only redraw a fixed frame after invalidate()
+    bool                redrawOnDemand;
+    bool                needsRedraw;
+
+    // The UI owns the table of transition ticks, copies are not supported
+    OLEDDisplayUi(const OLEDDisplayUi &);
+    OLEDDisplayUi &operator=(const OLEDDisplayUi &);
 
     uint8_t             getNextFrameNumber();
     void                drawIndicator();
@@ -173,6 +237,7 @@ class OLEDDisplayUi {
   public:
 
     OLEDDisplayUi(OLEDDisplay *display);
+    ~OLEDDisplayUi();
 
     /**
      * Initialise the display
@@ -180,10 +245,17 @@ class OLEDDisplayUi {
     void init();
 
     /**
-     * Configure the internal used target FPS
+     * Configure the internal used target FPS, 0 is treated as 1
      */
     void setTargetFPS(uint8_t fps);
 
+    /**
+     * Configure the FPS used while a fixed frame doesn't change, transitions
+     * and frames that call invalidate() still run at the target FPS.
+     * 0 (the default) always uses the target FPS.
+     */
+    void setIdleFPS(uint8_t fps);
+
     // Automatic Controll
     /**
      * Enable automatic transition to next frame after the some time can be configured with `setTimePerFrame` and `setTimePerTransition`.
@@ -276,6 +348,19 @@ class OLEDDisplayUi {
      */
     void setFrames(FrameCallback* frameFunctions, uint8_t frameCount);
 
+    /**
+     * Draw both frames of a transition only once when it starts and move the
+     * images afterwards. Frames that change during a transition can be marked
+     * with true in liveFrames (one entry per frame), they are drawn every tick.
+     * Needs memory for two images of the display.
+     */
+    void enableFrameCaching(const bool* liveFrames = NULL);
+
+    /**
+     * Draw the frames every tick again and free the images
+     */
+    void disableFrameCaching();
+
     // Overlay
 
     /**
@@ -313,9 +398,51 @@ class OLEDDisplayUi {
      */
     void transitionToFrame(uint8_t frame);
 
+    // Redrawing
+    /**
+     * Only redraw a fixed frame when invalidate() was called or the UI state changed,
+     * transitions are still drawn every tick. Saves the time of drawing and sending
+     * frames that didn't change.
+     */
+    void enableRedrawOnDemand();
+
+    /**
+     * Redraw every tick (the default)
+     */
+    void disableRedrawOnDemand();
+
+    /**
+     * The content of the frames or overlays changed, redraw them with the next tick
+     */
+    void invalidate();
+
     // State Info
     OLEDDisplayUiState* getUiState();
 
+    /**
+     * Milliseconds since start, does not overflow like millis() as long as
+     * it is called (for example by update()) at least every 49 days
+     */
+    uint64_t getMillis();
+
+    /**
+     * Microseconds since start, transitions and the time a frame is shown are
+     * measured with it. Does not overflow like micros() as long as it is called
+     * (for example by update()) at least every 71 minutes.
+     */
+    uint64_t getMicros();
+
+    /**
+     * The time (see getMillis()) the next tick is due. Nothing needs to be
+     * done before, the caller may sleep until then.
+     */
+    uint64_t getNextDeadline();
+
+    // This needs to be called in the main loop
+    // the returned value is the time (in ms) until the next tick is due,
+    // see getNextDeadline(), negative if the UI is running late.
+    // While a fixed frame is shown at the idle FPS this is longer than
+    // the interval of the target FPS, which used to be the upper limit.
     int16_t update();
 };
 #endif
@@ -42,6 +42,7 @@ class SH1106Spi : public OLEDDisplay {
   public:
     SH1106Spi(uint8_t _rst, uint8_t _dc, uint8_t _cs, OLEDDISPLAY_GEOMETRY g = GEOMETRY_128_64) {
         setGeometry(g);
+        flushPerPage = true;
 
       this->_rst = _rst;
       this->_dc  = _dc;
@@ -63,69 +64,26 @@ class SH1106Spi : public OLEDDisplay {
       return true;
     }
 
-    void display(void) {
-    #ifdef OLEDDISPLAY_DOUBLE_BUFFER
-       uint8_t minBoundY = UINT8_MAX;
-       uint8_t maxBoundY = 0;
-
-       uint8_t minBoundX = UINT8_MAX;
-       uint8_t maxBoundX = 0;
-
-       uint8_t x, y;
-
-       // Calculate the Y bounding box of changes
-       // and copy buffer[pos] to buffer_back[pos];
-       for (y = 0; y < (displayHeight / 8); y++) {
-         for (x = 0; x < displayWidth; x++) {
-          uint16_t pos = x + y * displayWidth;
-          if (buffer[pos] != buffer_back[pos]) {
-            minBoundY = _min(minBoundY, y);
-            maxBoundY = _max(maxBoundY, y);
-            minBoundX = _min(minBoundX, x);
-            maxBoundX = _max(maxBoundX, x);
-          }
-          buffer_back[pos] = buffer[pos];
-        }
-        yield();
-       }
-
-       // If the minBoundY wasn't updated
-       // we can savely assume that buffer_back[pos] == buffer[pos]
-       // holdes true for all values of pos
-       if (minBoundY == UINT8_MAX) return;
-
+  private:
+	int getBufferOffset(void) {
+		return 0;
+	}
+    void sendBuffer(uint16_t minBoundX, uint16_t maxBoundX, uint8_t minBoundY, uint8_t maxBoundY) {
        // Calculate the colum offset
        uint8_t minBoundXp2H = (minBoundX + 2) & 0x0F;
        uint8_t minBoundXp2L = 0x10 | ((minBoundX + 2) >> 4 );
 
-       for (y = minBoundY; y <= maxBoundY; y++) {
-         sendCommand(0xB0 + y);
+       for (uint8_t y = minBoundY; y <= maxBoundY; y++) {
+         sendCommand(0xB0 + toRamPage(y));
          sendCommand(minBoundXp2H);
          sendCommand(minBoundXp2L);
          digitalWrite(_dc, HIGH);   // data mode
-         for (x = minBoundX; x <= maxBoundX; x++) {
+         for (uint16_t x = minBoundX; x <= maxBoundX; x++) {
            SPI.transfer(buffer[x + y * displayWidth]);
          }
          yield();
        }
-     #else
-      for (uint8_t y=0; y<displayHeight/8; y++) {
-        sendCommand(0xB0 + y);
-        sendCommand(0x02);
-        sendCommand(0x10);
-        digitalWrite(_dc, HIGH);   // data mode
-        for( uint8_t x=0; x < displayWidth; x++) {
-          SPI.transfer(buffer[x + y * displayWidth]);
-        }
-        yield();
-      }
-     #endif
     }
-
-  private:
-	int getBufferOffset(void) {
-		return 0;
-	}
     inline void sendCommand(uint8_t com) __attribute__((always_inline)){
       digitalWrite(_dc, LOW);
       SPI.transfer(com);
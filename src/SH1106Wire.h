@@ -38,6 +38,17 @@
 #define SH1106_SET_PUMP_MODE 0XAD
 #define SH1106_PUMP_ON 0X8B
 #define SH1106_PUMP_OFF 0X8A
+
+// The bytes one Wire transaction can hold, a page goes out in as few of them as the core allows
+#ifndef SH1106_WIRE_BUFFER
+#if defined(I2C_BUFFER_LENGTH)
+#define SH1106_WIRE_BUFFER I2C_BUFFER_LENGTH
+#elif defined(BUFFER_LENGTH)
+#define SH1106_WIRE_BUFFER BUFFER_LENGTH
+#else
+#define SH1106_WIRE_BUFFER 32
+#endif
+#endif
 //--------------------------------------
 
 class SH1106Wire : public OLEDDisplay {
@@ -49,109 +60,86 @@ class SH1106Wire : public OLEDDisplay {
   public:
     SH1106Wire(uint8_t _address, uint8_t _sda, uint8_t _scl, OLEDDISPLAY_GEOMETRY g = GEOMETRY_128_64) {
       setGeometry(g);
+      flushPerPage = true;
 
       this->_address = _address;
       this->_sda = _sda;
       this->_scl = _scl;
-    }
 
-    bool connect() {
-      Wire.begin(this->_sda, this->_scl);
       // Let's use ~700khz if ESP8266 is in 160Mhz mode
       // this will be limited to ~400khz if the ESP8266 in 80Mhz mode.
-      Wire.setClock(700000);
-      return true;
+      busClock = 700000;
     }
 
-    void display(void) {
-      #ifdef OLEDDISPLAY_DOUBLE_BUFFER
-        uint8_t minBoundY = UINT8_MAX;
-        uint8_t maxBoundY = 0;
-
-        uint8_t minBoundX = UINT8_MAX;
-        uint8_t maxBoundX = 0;
-
-        uint8_t x, y;
-
-        // Calculate the Y bounding box of changes
-        // and copy buffer[pos] to buffer_back[pos];
-        for (y = 0; y < (displayHeight / 8); y++) {
-          for (x = 0; x < displayWidth; x++) {
-           uint16_t pos = x + y * displayWidth;
-           if (buffer[pos] != buffer_back[pos]) {
-             minBoundY = _min(minBoundY, y);
-             maxBoundY = _max(maxBoundY, y);
-             minBoundX = _min(minBoundX, x);
-             maxBoundX = _max(maxBoundX, x);
-           }
-           buffer_back[pos] = buffer[pos];
-         }
-         yield();
-        }
-
-        // If the minBoundY wasn't updated
-        // we can savely assume that buffer_back[pos] == buffer[pos]
-        // holdes true for all values of pos
-        if (minBoundY == UINT8_MAX) return;
-
-        // Calculate the colum offset
-        uint8_t minBoundXp2H = (minBoundX + 2) & 0x0F;
-        uint8_t minBoundXp2L = 0x10 | ((minBoundX + 2) >> 4 );
-
-        byte k = 0;
-        for (y = minBoundY; y <= maxBoundY; y++) {
-          sendCommand(0xB0 + y);
-          sendCommand(minBoundXp2H);
-          sendCommand(minBoundXp2L);
-          for (x = minBoundX; x <= maxBoundX; x++) {
-            if (k == 0) {
-              Wire.beginTransmission(_address);
-              Wire.write(0x40);
-            }
-            Wire.write(buffer[x + y * displayWidth]);
-            k++;
-            if (k == 16)  {
-              Wire.endTransmission();
-              k = 0;
-            }
-          }
-          if (k != 0)  {
-            Wire.endTransmission();
-            k = 0;
-          }
-          yield();
-        }
-
-        if (k != 0) {
-          Wire.endTransmission();
-        }
-      #else
-        uint8_t * p = &buffer[0];
-        for (uint8_t y=0; y<8; y++) {
-          sendCommand(0xB0+y);
-          sendCommand(0x02);
-          sendCommand(0x10);
-          for( uint8_t x=0; x<8; x++) {
-            Wire.beginTransmission(_address);
-            Wire.write(0x40);
-            for (uint8_t k = 0; k < 16; k++) {
-              Wire.write(*p++);
-            }
-            Wire.endTransmission();
-          }
-        }
-      #endif
+    bool connect() {
+      beginBus();
+      return true;
     }
 
   private:
+    bool getBusPins(uint8_t &sda, uint8_t &scl) {
+      sda = this->_sda;
+      scl = this->_scl;
+      return true;
+    }
+    uint8_t getBusAddress() {
+      return this->_address;
+    }
+    void beginBus() {
+      Wire.begin(this->_sda, this->_scl);
+      // Some cores reset the clock in begin()
+      Wire.setClock(busClock);
+      wireBoundPins() = this->_sda << 8 | this->_scl;
+    }
+    void applyBusClock() {
+      if (wireBoundPins() == (this->_sda << 8 | this->_scl)) {
+        Wire.setClock(busClock);
+      }
+    }
+
 	int getBufferOffset(void) {
 		return 0;
 	}
+    void sendBuffer(uint16_t minBoundX, uint16_t maxBoundX, uint8_t minBoundY, uint8_t maxBoundY) {
+      // Calculate the colum offset
+      uint8_t minBoundXp2H = (minBoundX + 2) & 0x0F;
+      uint8_t minBoundXp2L = 0x10 | ((minBoundX + 2) >> 4 );
+
+      for (uint8_t y = minBoundY; y <= maxBoundY; y++) {
+        // The page and column commands start the transaction of the data,
+        // each of them behind a control byte with the continuation bit set
+        Wire.beginTransmission(_address);
+        Wire.write(0x80);
+        Wire.write(0xB0 + toRamPage(y));
+        Wire.write(0x80);
+        Wire.write(minBoundXp2H);
+        Wire.write(0x80);
+        Wire.write(minBoundXp2L);
+        Wire.write(0x40);
+
+        // The span straight from the buffer, in pieces that fill the Wire buffer
+        // behind the 7 command bytes and then behind a single control byte
+        uint16_t x = minBoundX;
+        uint16_t room = SH1106_WIRE_BUFFER - 7;
+        while (true) {
+          uint16_t length = maxBoundX - x + 1 < room ? maxBoundX - x + 1 : room;
+          Wire.write(&buffer[x + y * displayWidth], length);
+          busTransferDone(Wire.endTransmission() == 0);
+          x += length;
+          if (x > maxBoundX) break;
+
+          Wire.beginTransmission(_address);
+          Wire.write(0x40);
+          room = SH1106_WIRE_BUFFER - 1;
+        }
+        yield();
+      }
+    }
     inline void sendCommand(uint8_t command) __attribute__((always_inline)){
       Wire.beginTransmission(_address);
       Wire.write(0x80);
       Wire.write(command);
-      Wire.endTransmission();
+      busTransferDone(Wire.endTransmission() == 0);
     }
 
 
@@ -53,109 +53,57 @@ class SSD1306Brzo : public OLEDDisplay {
       this->_address = _address;
       this->_sda = _sda;
       this->_scl = _scl;
+      busClock = BRZO_I2C_SPEED * 1000L;
     }
 
     bool connect(){
-      brzo_i2c_setup(_sda, _scl, 0);
+      beginBus();
       return true;
     }
 
-    void display(void) {
-    #ifdef OLEDDISPLAY_DOUBLE_BUFFER
-       uint8_t minBoundY = UINT8_MAX;
-       uint8_t maxBoundY = 0;
-
-       uint8_t minBoundX = UINT8_MAX;
-       uint8_t maxBoundX = 0;
-
-       uint8_t x, y;
-
-       // Calculate the Y bounding box of changes
-       // and copy buffer[pos] to buffer_back[pos];
-       for (y = 0; y < (displayHeight / 8); y++) {
-         for (x = 0; x < displayWidth; x++) {
-          uint16_t pos = x + y * displayWidth;
-          if (buffer[pos] != buffer_back[pos]) {
-            minBoundY = _min(minBoundY, y);
-            maxBoundY = _max(maxBoundY, y);
-            minBoundX = _min(minBoundX, x);
-            maxBoundX = _max(maxBoundX, x);
-          }
-          buffer_back[pos] = buffer[pos];
-        }
-        yield();
-       }
-
-       // If the minBoundY wasn't updated
-       // we can savely assume that buffer_back[pos] == buffer[pos]
-       // holdes true for all values of pos
-       if (minBoundY == UINT8_MAX) return;
-
-       sendCommand(COLUMNADDR);
-       sendCommand(minBoundX);
-       sendCommand(maxBoundX);
-
-       sendCommand(PAGEADDR);
-       sendCommand(minBoundY);
-       sendCommand(maxBoundY);
-
-       byte k = 0;
-       uint8_t sendBuffer[17];
-       sendBuffer[0] = 0x40;
-       brzo_i2c_start_transaction(this->_address, BRZO_I2C_SPEED);
-       for (y = minBoundY; y <= maxBoundY; y++) {
-           for (x = minBoundX; x <= maxBoundX; x++) {
-               k++;
-               sendBuffer[k] = buffer[x + y * displayWidth];
-               if (k == 16)  {
-                 brzo_i2c_write(sendBuffer, 17, true);
-                 k = 0;
-               }
-           }
-           yield();
-       }
-       brzo_i2c_write(sendBuffer, k + 1, true);
-       brzo_i2c_end_transaction();
-     #else
-       // No double buffering
-       sendCommand(COLUMNADDR);
-       sendCommand(0x0);
-       sendCommand(0x7F);
-
-       sendCommand(PAGEADDR);
-       sendCommand(0x0);
-
-       if (geometry == GEOMETRY_128_64) {
-         sendCommand(0x7);
-       } else if (geometry == GEOMETRY_128_32) {
-         sendCommand(0x3);
-       }
-
-       uint8_t sendBuffer[17];
-       sendBuffer[0] = 0x40;
-       brzo_i2c_start_transaction(this->_address, BRZO_I2C_SPEED);
-       for (uint16_t i=0; i<displayBufferSize; i++) {
-         for (uint8_t x=1; x<17; x++) {
-           sendBuffer[x] = buffer[i];
-           i++;
-         }
-         i--;
-         brzo_i2c_write(sendBuffer,  17,  true);
-         yield();
-       }
-       brzo_i2c_end_transaction();
-     #endif
+  private:
+    bool getBusPins(uint8_t &sda, uint8_t &scl) {
+      sda = this->_sda;
+      scl = this->_scl;
+      return true;
+    }
+    uint8_t getBusAddress() {
+      return this->_address;
+    }
+    void beginBus() {
+      brzo_i2c_setup(_sda, _scl, 0);
     }
 
-  private:
 	int getBufferOffset(void) {
 		return 0;
 	}
+    void sendBuffer(uint16_t minBoundX, uint16_t maxBoundX, uint8_t minBoundY, uint8_t maxBoundY) {
+       // The window behind a single control byte for a stream of commands
+       uint8_t commands[7] = {0x00 /* command stream */, COLUMNADDR, (uint8_t) minBoundX, (uint8_t) maxBoundX,
+                              PAGEADDR, toRamPage(minBoundY), toRamPage(maxBoundY)};
+       brzo_i2c_start_transaction(this->_address, busClock / 1000);
+       brzo_i2c_write(commands, sizeof(commands), true);
+
+       // Every write of brzo_i2c starts with the address again and needs a control byte of its own,
+       // the rows are copied behind one in pieces of up to 128 bytes. The buffer itself is never written.
+       uint8_t data[1 + 128];
+       data[0] = 0x40; // data stream
+       for (uint8_t y = minBoundY; y <= maxBoundY; y++) {
+           for (uint16_t x = minBoundX; x <= maxBoundX; ) {
+               uint16_t length = maxBoundX - x + 1 < 128 ? maxBoundX - x + 1 : 128;
+               memcpy(data + 1, &buffer[x + y * displayWidth], length);
+               brzo_i2c_write(data, length + 1, true);
+               x += length;
+           }
+           yield();
+       }
+       busTransferDone(brzo_i2c_end_transaction() == 0);
+    }
     inline void sendCommand(uint8_t com) __attribute__((always_inline)){
       uint8_t command[2] = {0x80 /* command mode */, com};
-      brzo_i2c_start_transaction(_address, BRZO_I2C_SPEED);
+      brzo_i2c_start_transaction(_address, busClock / 1000);
       brzo_i2c_write(command, 2, true);
-      brzo_i2c_end_transaction();
+      busTransferDone(brzo_i2c_end_transaction() == 0);
     }
 };
 
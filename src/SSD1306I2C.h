@@ -36,10 +36,6 @@
 #include "OLEDDisplay.h"
 #include <mbed.h>
 
-#ifndef UINT8_MAX
- #define UINT8_MAX 0xff
-#endif
-
 class SSD1306I2C : public OLEDDisplay {
 public:
     SSD1306I2C(uint8_t _address, PinName _sda, PinName _scl, OLEDDISPLAY_GEOMETRY g = GEOMETRY_128_64) {
@@ -49,96 +45,92 @@ public:
       this->_sda = _sda;
       this->_scl = _scl;
 	  _i2c = new I2C(_sda, _scl);
-    }
 
-    bool connect() {
 		// mbed supports 100k and 400k some device maybe 1000k
 #ifdef TARGET_STM32L4
-	  _i2c->frequency(1000000);
+	  busClock = 1000000;
 #else
-	  _i2c->frequency(400000);
+	  busClock = 400000;
 #endif
+    }
+
+    bool connect() {
+	  _i2c->frequency(busClock);
       return true;
     }
 
-    void display(void) {
-      const int x_offset = (128 - this->width()) / 2;
-#ifdef OLEDDISPLAY_DOUBLE_BUFFER
-        uint8_t minBoundY = UINT8_MAX;
-        uint8_t maxBoundY = 0;
-
-        uint8_t minBoundX = UINT8_MAX;
-        uint8_t maxBoundX = 0;
-        uint8_t x, y;
-
-        // Calculate the Y bounding box of changes
-        // and copy buffer[pos] to buffer_back[pos];
-        for (y = 0; y < (this->height() / 8); y++) {
-          for (x = 0; x < this->width(); x++) {
-           uint16_t pos = x + y * this->width();
-           if (buffer[pos] != buffer_back[pos]) {
-             minBoundY = std::min(minBoundY, y);
-             maxBoundY = std::max(maxBoundY, y);
-             minBoundX = std::min(minBoundX, x);
-             maxBoundX = std::max(maxBoundX, x);
-           }
-           buffer_back[pos] = buffer[pos];
-         }
-         yield();
-        }
+private:
+    uint8_t getBusAddress() {
+      return this->_address >> 1;
+    }
+    void applyBusClock() {
+	  _i2c->frequency(busClock);
+    }
 
-        // If the minBoundY wasn't updated
-        // we can savely assume that buffer_back[pos] == buffer[pos]
-        // holdes true for all values of pos
+	// One byte in front of the buffer for the control byte of the first row
+	int getBufferOffset(void) {
+		return 1;
+	}
 
-        if (minBoundY == UINT8_MAX) return;
+    void sendBuffer(uint16_t minBoundX, uint16_t maxBoundX, uint8_t minBoundY, uint8_t maxBoundY) {
+        const int x_offset = (128 - this->width()) / 2;
 
         sendCommand(COLUMNADDR);
         sendCommand(x_offset + minBoundX);	// column start address (0 = reset)
         sendCommand(x_offset + maxBoundX);	// column end address (127 = reset)
 
         sendCommand(PAGEADDR);
-        sendCommand(minBoundY);				// page start address
-        sendCommand(maxBoundY);				// page end address
-
-        for (y = minBoundY; y <= maxBoundY; y++) {
-			uint8_t *start = &buffer[(minBoundX + y * this->width())-1];
-			uint8_t save = *start;
-			
-			*start = 0x40; // control
-			_i2c->write(_address, (char *)start, (maxBoundX-minBoundX) + 1 + 1);
-			*start = save;
-		}
-#else
-
-        sendCommand(COLUMNADDR);
-        sendCommand(x_offset);						// column start address (0 = reset)
-        sendCommand(x_offset + (this->width() - 1));// column end address (127 = reset)
+        sendCommand(toRamPage(minBoundY));				// page start address
+        sendCommand(toRamPage(maxBoundY));				// page end address
 
-        sendCommand(PAGEADDR);
-        sendCommand(0x0);							// page start address (0 = reset)
-
-        if (geometry == GEOMETRY_128_64) {
-          sendCommand(0x7);
-        } else if (geometry == GEOMETRY_128_32) {
-          sendCommand(0x3);
+        if (bufferLent) {
+            sendLentBuffer(minBoundX, maxBoundX, minBoundY, maxBoundY);
+            return;
         }
 
-		buffer[-1] = 0x40; // control
-		_i2c->write(_address, (char *)&buffer[-1], displayBufferSize + 1);
-#endif
+        // The block write of mbed needs the control byte in front of the data, it takes the
+        // place of the byte before the rows for the time of the write. Our own buffer has the
+        // headroom of getBufferOffset() in front of it. Rows of the full width follow each
+        // other in the buffer and go out in one write, narrower rows one write each.
+        uint16_t width = this->width();
+        bool fullWidth = minBoundX == 0 && maxBoundX == width - 1;
+        uint16_t length = fullWidth ? (maxBoundY - minBoundY + 1) * width : maxBoundX - minBoundX + 1;
+        bool ok = true;
+        for (uint8_t y = minBoundY; y <= maxBoundY && ok; y++) {
+            char *data = (char *) &buffer[minBoundX + y * width - 1];
+            char saved = *data;
+            *data = 0x40;	// control
+            ok = _i2c->write(_address, data, length + 1) == 0;
+            *data = saved;
+            if (fullWidth) break;
+        }
+        busTransferDone(ok);
     }
 
-private:
-	int getBufferOffset(void) {
-		return 0;
-	}
+    // A lent buffer has no headroom and the byte before a row may be shown by another panel,
+    // so the rows go out byte by byte behind the control byte in one transaction. That
+    // costs a call per byte, but keeps the buffer untouched.
+    void sendLentBuffer(uint16_t minBoundX, uint16_t maxBoundX, uint8_t minBoundY, uint8_t maxBoundY) {
+        // Stops at the first byte that isn't acknowledged (write() returns 1 for an ACK)
+        _i2c->lock();
+        _i2c->start();
+        bool ok = _i2c->write(_address) == 1 && _i2c->write(0x40) == 1; // control
+        for (uint8_t y = minBoundY; y <= maxBoundY && ok; y++) {
+            const uint8_t *data = &buffer[minBoundX + y * this->width()];
+            for (uint16_t x = minBoundX; x <= maxBoundX && ok; x++) {
+                ok = _i2c->write(*data++) == 1;
+            }
+        }
+        _i2c->stop();
+        _i2c->unlock();
+        busTransferDone(ok);
+    }
 
     inline void sendCommand(uint8_t command) __attribute__((always_inline)) {
 		char _data[2];
 	  	_data[0] = 0x80; // control
 	  	_data[1] = command;
-	  	_i2c->write(_address, _data, sizeof(_data));
+	  	busTransferDone(_i2c->write(_address, _data, sizeof(_data)) == 0);
     }
 
 	uint8_t             _address;
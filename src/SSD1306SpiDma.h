@@ -0,0 +1,288 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018 by ThingPulse, Daniel Eichhorn
+ * Copyright (c) 2018 by Fabrice Weinberg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ThingPulse invests considerable time and money to develop these open source libraries.
+ * Please support us by buying our products (and not the clones) from
+ * https://thingpulse.com
+ *
+ */
+
+#ifndef SSD1306SpiDma_h
+#define SSD1306SpiDma_h
+
+#ifdef ARDUINO_ARCH_ESP32
+
+#include "OLEDDisplay.h"
+#include <driver/spi_master.h>
+#include <driver/gpio.h>
+#include <esp_heap_caps.h>
+#if __has_include(<esp_idf_version.h>)
+#include <esp_idf_version.h>
+#endif
+
+#if defined(ESP_IDF_VERSION_MAJOR) && (ESP_IDF_VERSION_MAJOR > 4 || (ESP_IDF_VERSION_MAJOR == 4 && ESP_IDF_VERSION_MINOR >= 3))
+#define SSD1306SPIDMA_CHANNEL SPI_DMA_CH_AUTO
+#else
+#define SSD1306SPIDMA_CHANNEL 1
+#endif
+
+// SSD1306 on the SPI peripheral of the ESP32, flushed by DMA. display() copies the changed
+// windows into one of two staging buffers, queues them and returns while they are still being
+// sent, so the next frame can be drawn in the meantime. The bus belongs to this display alone.
+class SSD1306SpiDma : public OLEDDisplay {
+  private:
+      uint8_t             _rst;
+      uint8_t             _dc;
+      uint8_t             _cs;
+      uint8_t             _sclk;
+      uint8_t             _mosi;
+      spi_host_device_t   _host;
+      int                 _clock;
+      spi_device_handle_t _spi;
+
+      // The windows of a flush (command window and data) wait in a staging buffer until
+      // they are sent. A buffer is filled until it is full, then the other one is used.
+      struct Staging {
+        uint8_t           *data;
+        uint16_t          used;
+        spi_transaction_t *transactions;
+        uint8_t           count;
+        // Sequence number of its last queued transaction
+        uint32_t          lastQueued;
+      };
+      Staging             staging[2];
+      uint8_t             current;
+      uint16_t            stagingSize;
+      uint8_t             stagingTransactions;
+
+      // Transactions queued and finished since connect()
+      uint32_t            queued;
+      uint32_t            finished;
+
+  public:
+    SSD1306SpiDma(uint8_t _rst, uint8_t _dc, uint8_t _cs, uint8_t _sclk, uint8_t _mosi,
+                  OLEDDISPLAY_GEOMETRY g = GEOMETRY_128_64, spi_host_device_t _host = SPI2_HOST, int _clock = 10000000) {
+      setGeometry(g);
+
+      this->_rst   = _rst;
+      this->_dc    = _dc;
+      this->_cs    = _cs;
+      this->_sclk  = _sclk;
+      this->_mosi  = _mosi;
+      this->_host  = _host;
+      this->_clock = _clock;
+      this->_spi   = NULL;
+      memset(staging, 0, sizeof(staging));
+      this->queued = 0;
+      this->finished = 0;
+    }
+
+    ~SSD1306SpiDma() {
+      if (_spi == NULL) return;
+      waitForFlush();
+      disconnect();
+    }
+
+    bool connect() {
+      // Connected already, e.g. by addMirror()
+      if (_spi != NULL) return true;
+
+      pinMode(_dc, OUTPUT);
+      pinMode(_rst, OUTPUT);
+
+      // Pulse Reset low for 10ms
+      digitalWrite(_rst, HIGH);
+      delay(1);
+      digitalWrite(_rst, LOW);
+      delay(10);
+      digitalWrite(_rst, HIGH);
+
+      // Every page may be a window of its own: 6 command bytes and the data, both
+      // starting at a word boundary for the DMA
+      uint8_t pages = panelHeight() / 8;
+      stagingSize = displayBufferSize + pages * 11;
+      stagingTransactions = pages * 2;
+
+      spi_bus_config_t bus;
+      memset(&bus, 0, sizeof(bus));
+      bus.mosi_io_num = _mosi;
+      bus.miso_io_num = -1;
+      bus.sclk_io_num = _sclk;
+      bus.quadwp_io_num = -1;
+      bus.quadhd_io_num = -1;
+      bus.max_transfer_sz = displayBufferSize;
+      if (spi_bus_initialize(_host, &bus, SSD1306SPIDMA_CHANNEL) != ESP_OK) {
+        return false;
+      }
+
+      spi_device_interface_config_t device;
+      memset(&device, 0, sizeof(device));
+      device.mode = 0;
+      device.clock_speed_hz = _clock;
+      device.spics_io_num = _cs;
+      device.queue_size = stagingTransactions * 2;
+      device.pre_cb = setDataCommand;
+      if (spi_bus_add_device(_host, &device, &_spi) != ESP_OK) {
+        spi_bus_free(_host);
+        _spi = NULL;
+        return false;
+      }
+
+      for (uint8_t i = 0; i < 2; i++) {
+        staging[i].data = (uint8_t *) heap_caps_malloc(stagingSize, MALLOC_CAP_DMA);
+        staging[i].transactions = (spi_transaction_t *) malloc(stagingTransactions * sizeof(spi_transaction_t));
+        staging[i].used = 0;
+        staging[i].count = 0;
+        staging[i].lastQueued = 0;
+        if (staging[i].data == NULL || staging[i].transactions == NULL) {
+          DEBUG_OLEDDISPLAY("[OLEDDISPLAY][init] Not enough memory for the DMA staging buffers\n");
+          // Start over with the next connect()
+          disconnect();
+          return false;
+        }
+      }
+      current = 0;
+      queued = 0;
+      finished = 0;
+      return true;
+    }
+
+    // True while windows queued by display() are still being sent
+    bool isFlushing() {
+      spi_transaction_t *done;
+      while (finished < queued && spi_device_get_trans_result(_spi, &done, 0) == ESP_OK) {
+        finished++;
+      }
+      return finished < queued;
+    }
+
+    // Wait until everything queued by display() has been sent
+    void waitForFlush() {
+      waitFor(queued);
+    }
+
+  private:
+	int getBufferOffset(void) {
+		return 0;
+	}
+
+    // Runs in the interrupt before every transaction, the level of the D/C pin is passed in `user`
+    static void IRAM_ATTR setDataCommand(spi_transaction_t *transaction) {
+      uintptr_t user = (uintptr_t) transaction->user;
+      gpio_set_level((gpio_num_t) (user >> 1), user & 1);
+    }
+
+    // Free the staging buffers and release the bus, nothing may be queued
+    void disconnect() {
+      for (uint8_t i = 0; i < 2; i++) {
+        heap_caps_free(staging[i].data);
+        free(staging[i].transactions);
+        staging[i].data = NULL;
+        staging[i].transactions = NULL;
+      }
+      spi_bus_remove_device(_spi);
+      spi_bus_free(_host);
+      _spi = NULL;
+    }
+
+    void waitFor(uint32_t sequence) {
+      spi_transaction_t *done;
+      while (finished < sequence && spi_device_get_trans_result(_spi, &done, portMAX_DELAY) == ESP_OK) {
+        finished++;
+      }
+    }
+
+    // Switch to the other staging buffer (once it is sent) if the current one has
+    // no room for `length` more bytes in two more transactions
+    void reserve(uint16_t length) {
+      Staging *s = &staging[current];
+      if (s->used + length <= stagingSize && s->count + 2 <= stagingTransactions) return;
+
+      current ^= 1;
+      s = &staging[current];
+      waitFor(s->lastQueued);
+      s->used = 0;
+      s->count = 0;
+    }
+
+    // Take `length` bytes of the current staging buffer, the next part starts at a word boundary for the DMA
+    uint8_t *stage(uint16_t length) {
+      Staging *s = &staging[current];
+      uint8_t *data = s->data + s->used;
+      s->used += (length + 3) & ~3;
+      return data;
+    }
+
+    void queue(const uint8_t *data, uint16_t length, bool isData) {
+      Staging *s = &staging[current];
+      spi_transaction_t *transaction = &s->transactions[s->count++];
+      memset(transaction, 0, sizeof(spi_transaction_t));
+      transaction->length = length * 8;
+      transaction->tx_buffer = data;
+      transaction->user = (void *) (uintptr_t) (_dc << 1 | isData);
+      if (spi_device_queue_trans(_spi, transaction, portMAX_DELAY) == ESP_OK) {
+        s->lastQueued = ++queued;
+      }
+    }
+
+    void sendBuffer(uint16_t minBoundX, uint16_t maxBoundX, uint8_t minBoundY, uint8_t maxBoundY) {
+      uint16_t columns = maxBoundX - minBoundX + 1;
+      uint16_t length = columns * (maxBoundY - minBoundY + 1);
+
+      reserve(8 + ((length + 3) & ~3));
+
+      uint8_t *commands = stage(6);
+      commands[0] = COLUMNADDR;
+      commands[1] = minBoundX;
+      commands[2] = maxBoundX;
+      commands[3] = PAGEADDR;
+      commands[4] = toRamPage(minBoundY);
+      commands[5] = toRamPage(maxBoundY);
+      queue(commands, 6, false);
+
+      // The rows one after the other, the display wraps around at the end of the window
+      uint8_t *data = stage(length);
+      for (uint8_t y = minBoundY; y <= maxBoundY; y++) {
+        memcpy(data + (y - minBoundY) * columns, &buffer[minBoundX + y * displayWidth], columns);
+      }
+      queue(data, length, true);
+    }
+
+    inline void sendCommand(uint8_t com) __attribute__((always_inline)){
+      // In order with the windows that are still queued
+      waitForFlush();
+
+      spi_transaction_t transaction;
+      memset(&transaction, 0, sizeof(transaction));
+      transaction.flags = SPI_TRANS_USE_TXDATA;
+      transaction.length = 8;
+      transaction.tx_data[0] = com;
+      transaction.user = (void *) (uintptr_t) (_dc << 1);
+      spi_device_transmit(_spi, &transaction);
+    }
+};
+
+#endif
+
+#endif
@@ -53,133 +53,99 @@ class SSD1306Wire : public OLEDDisplay {
       this->_address = _address;
       this->_sda = _sda;
       this->_scl = _scl;
+
+      // Let's use ~700khz if ESP8266 is in 160Mhz mode
+      // this will be limited to ~400khz if the ESP8266 in 80Mhz mode.
+      busClock = 700000;
     }
 
     bool connect() {
+      beginBus();
+      return true;
+    }
+
+    void setI2cAutoInit(bool doI2cAutoInit) {
+      _doI2cAutoInit = doI2cAutoInit;
+    }
+
+  private:
+    bool getBusPins(uint8_t &sda, uint8_t &scl) {
+      sda = this->_sda;
+      scl = this->_scl;
+      return true;
+    }
+    uint8_t getBusAddress() {
+      return this->_address;
+    }
+    void beginBus() {
 #ifdef ARDUINO_ARCH_AVR 
       Wire.begin();
 #else
       Wire.begin(this->_sda, this->_scl);
 #endif
-      // Let's use ~700khz if ESP8266 is in 160Mhz mode
-      // this will be limited to ~400khz if the ESP8266 in 80Mhz mode.
-      Wire.setClock(700000);
-      return true;
+      // Some cores reset the clock in begin()
+      Wire.setClock(busClock);
+      wireBoundPins() = this->_sda << 8 | this->_scl;
+    }
+    void applyBusClock() {
+      if (wireBoundPins() == (this->_sda << 8 | this->_scl)) {
+        Wire.setClock(busClock);
+      }
     }
 
-    void display(void) {
+	int getBufferOffset(void) {
+		return 0;
+	}
+    void sendBuffer(uint16_t minBoundX, uint16_t maxBoundX, uint8_t minBoundY, uint8_t maxBoundY) {
       initI2cIfNeccesary();
       const int x_offset = (128 - this->width()) / 2;
-      #ifdef OLEDDISPLAY_DOUBLE_BUFFER
-        uint8_t minBoundY = UINT8_MAX;
-        uint8_t maxBoundY = 0;
-
-        uint8_t minBoundX = UINT8_MAX;
-        uint8_t maxBoundX = 0;
-        uint8_t x, y;
-
-        // Calculate the Y bounding box of changes
-        // and copy buffer[pos] to buffer_back[pos];
-        for (y = 0; y < (this->height() / 8); y++) {
-          for (x = 0; x < this->width(); x++) {
-           uint16_t pos = x + y * this->width();
-           if (buffer[pos] != buffer_back[pos]) {
-             minBoundY = _min(minBoundY, y);
-             maxBoundY = _max(maxBoundY, y);
-             minBoundX = _min(minBoundX, x);
-             maxBoundX = _max(maxBoundX, x);
-           }
-           buffer_back[pos] = buffer[pos];
-         }
-         yield();
-        }
 
-        // If the minBoundY wasn't updated
-        // we can savely assume that buffer_back[pos] == buffer[pos]
-        // holdes true for all values of pos
-
-        if (minBoundY == UINT8_MAX) return;
-
-        sendCommand(COLUMNADDR);
-        sendCommand(x_offset + minBoundX);
-        sendCommand(x_offset + maxBoundX);
-
-        sendCommand(PAGEADDR);
-        sendCommand(minBoundY);
-        sendCommand(maxBoundY);
-
-        byte k = 0;
-        for (y = minBoundY; y <= maxBoundY; y++) {
-          for (x = minBoundX; x <= maxBoundX; x++) {
-            if (k == 0) {
-              Wire.beginTransmission(_address);
-              Wire.write(0x40);
-            }
-
-            Wire.write(buffer[x + y * this->width()]);
-            k++;
-            if (k == 16)  {
-              Wire.endTransmission();
-              k = 0;
-            }
+      sendCommand(COLUMNADDR);
+      sendCommand(x_offset + minBoundX);
+      sendCommand(x_offset + maxBoundX);
+
+      sendCommand(PAGEADDR);
+      sendCommand(toRamPage(minBoundY));
+      sendCommand(toRamPage(maxBoundY));
+
+      byte k = 0;
+      for (uint8_t y = minBoundY; y <= maxBoundY; y++) {
+        uint16_t x = minBoundX;
+        while (x <= maxBoundX) {
+          if (k == 0) {
+            Wire.beginTransmission(_address);
+            Wire.write(0x40);
           }
-          yield();
-        }
-
-        if (k != 0) {
-          Wire.endTransmission();
-        }
-      #else
-
-        sendCommand(COLUMNADDR);
-        sendCommand(x_offset);
-        sendCommand(x_offset + (this->width() - 1));
-
-        sendCommand(PAGEADDR);
-        sendCommand(0x0);
 
-        if (geometry == GEOMETRY_128_64) {
-          sendCommand(0x7);
-        } else if (geometry == GEOMETRY_128_32) {
-          sendCommand(0x3);
-        }
-
-        for (uint16_t i=0; i < displayBufferSize; i++) {
-          Wire.beginTransmission(this->_address);
-          Wire.write(0x40);
-          for (uint8_t x = 0; x < 16; x++) {
-            Wire.write(buffer[i]);
-            i++;
+          // As much of the row as fits into the transaction, straight from the buffer
+          uint8_t length = _min(maxBoundX - x + 1, 16 - k);
+          Wire.write(&buffer[x + y * this->width()], length);
+          x += length;
+          k += length;
+          if (k == 16)  {
+            busTransferDone(Wire.endTransmission() == 0);
+            k = 0;
           }
-          i--;
-          Wire.endTransmission();
         }
-      #endif
-    }
+        yield();
+      }
 
-    void setI2cAutoInit(bool doI2cAutoInit) {
-      _doI2cAutoInit = doI2cAutoInit;
+      if (k != 0) {
+        busTransferDone(Wire.endTransmission() == 0);
+      }
     }
-
-  private:
-	int getBufferOffset(void) {
-		return 0;
-	}
     inline void sendCommand(uint8_t command) __attribute__((always_inline)){
       initI2cIfNeccesary();
       Wire.beginTransmission(_address);
       Wire.write(0x80);
       Wire.write(command);
-      Wire.endTransmission();
+      busTransferDone(Wire.endTransmission() == 0);
     }
 
     void initI2cIfNeccesary() {
-      if (_doI2cAutoInit) {
-#ifdef ARDUINO_ARCH_AVR 
-      	Wire.begin();
-#else
-      	Wire.begin(this->_sda, this->_scl);
-#endif
+      // Only bind again if another display moved Wire to other pins
+      if (_doI2cAutoInit && wireBoundPins() != (this->_sda << 8 | this->_scl)) {
+        beginBus();
       }
     }
 
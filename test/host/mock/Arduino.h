@@ -0,0 +1,57 @@
+// The parts of the Arduino core the library uses, enough to build it on the host
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <algorithm>
+
+#define PROGMEM
+#define PI 3.14159265358979323846
+#define pgm_read_byte(addr) (*(const unsigned char *)(addr))
+#define pgm_read_word(addr) (*(const unsigned short *)(addr))
+#define OUTPUT 1
+#define HIGH 1
+#define LOW 0
+#define _min(a,b) ((a)<(b)?(a):(b))
+#define _max(a,b) ((a)>(b)?(a):(b))
+
+typedef uint8_t byte;
+using std::min;
+using std::max;
+
+inline unsigned long millis() { return 0; }
+inline unsigned long micros() { return 0; }
+inline void yield() {}
+inline void delay(unsigned long) {}
+inline void delayMicroseconds(unsigned int) {}
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+
+class String {
+  public:
+    String(const char *s = "") : s(s) {}
+    String(const std::string &s) : s(s) {}
+    unsigned int length() const { return s.size(); }
+    const char *c_str() const { return s.c_str(); }
+    char operator[](unsigned int i) const { return i < s.size() ? s[i] : 0; }
+    void toCharArray(char *buf, unsigned int size, unsigned int index = 0) const {
+      strncpy(buf, s.c_str() + index, size);
+      if (size) buf[size - 1] = 0;
+    }
+  private:
+    std::string s;
+};
+
+class Print {
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t) = 0;
+    size_t print(const char *s) {
+      size_t n = 0;
+      while (*s) n += write((uint8_t) *s++);
+      return n;
+    }
+};
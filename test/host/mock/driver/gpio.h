@@ -0,0 +1,8 @@
+#pragma once
+
+typedef int gpio_num_t;
+
+// The level of the D/C pin, set by the pre-transaction callback
+extern int mockDataCommand;
+
+inline void gpio_set_level(gpio_num_t, int level) { mockDataCommand = level; }
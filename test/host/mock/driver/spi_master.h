@@ -0,0 +1,156 @@
+// The spi_master queue of ESP-IDF on the host. Queued transactions stay in the queue until
+// the test lets the "hardware" finish them (mockFinish) or the driver blocks on a result,
+// and only then are their bytes read, like the DMA does. A staging buffer that is written
+// again before its transaction is finished is caught by comparing the bytes at both times.
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <deque>
+#include <vector>
+
+typedef int esp_err_t;
+#define ESP_OK 0
+#define ESP_FAIL -1
+#define ESP_ERR_TIMEOUT 0x107
+#define portMAX_DELAY 0xFFFFFFFF
+#define IRAM_ATTR
+#define SPI_TRANS_USE_TXDATA 4
+
+typedef enum { SPI1_HOST = 0, SPI2_HOST = 1, SPI3_HOST = 2 } spi_host_device_t;
+
+struct spi_transaction_t {
+  uint32_t flags;
+  uint16_t cmd;
+  uint64_t addr;
+  size_t length;
+  size_t rxlength;
+  void *user;
+  union {
+    const void *tx_buffer;
+    uint8_t tx_data[4];
+  };
+  void *rx_buffer;
+};
+typedef void (*transaction_cb_t)(spi_transaction_t *transaction);
+
+struct spi_bus_config_t {
+  int mosi_io_num, miso_io_num, sclk_io_num, quadwp_io_num, quadhd_io_num;
+  int max_transfer_sz;
+  uint32_t flags;
+};
+
+struct spi_device_interface_config_t {
+  uint8_t command_bits, address_bits, dummy_bits, mode;
+  int clock_speed_hz;
+  int spics_io_num;
+  uint32_t flags;
+  int queue_size;
+  transaction_cb_t pre_cb, post_cb;
+};
+
+// A transfer as it went out: the level of D/C and the bytes
+struct MockTransfer {
+  int dataCommand;
+  std::vector<uint8_t> bytes;
+};
+
+struct MockQueued {
+  spi_transaction_t *transaction;
+  std::vector<uint8_t> bytes;
+};
+
+struct spi_device_t {
+  spi_device_interface_config_t config;
+  std::deque<MockQueued> queue;
+};
+typedef spi_device_t *spi_device_handle_t;
+
+extern int mockDataCommand;
+extern std::vector<MockTransfer> mockTransfers;
+// Transactions the hardware may finish before a non-blocking call for a result
+extern int mockFinished;
+// Buses initialized and not freed, and the transfer size of the last one
+extern int mockBuses;
+extern int mockMaxTransfer;
+
+inline void mockFail(const char *reason) {
+  fprintf(stderr, "spi_master mock: %s\n", reason);
+  abort();
+}
+
+inline const uint8_t *mockBytes(spi_transaction_t *t) {
+  return (t->flags & SPI_TRANS_USE_TXDATA) ? t->tx_data : (const uint8_t *) t->tx_buffer;
+}
+
+inline void mockSend(spi_device_handle_t device, spi_transaction_t *t) {
+  device->config.pre_cb(t);
+  const uint8_t *bytes = mockBytes(t);
+  mockTransfers.push_back({ mockDataCommand, std::vector<uint8_t>(bytes, bytes + t->length / 8) });
+}
+
+inline esp_err_t spi_bus_initialize(spi_host_device_t, const spi_bus_config_t *bus, int) {
+  mockMaxTransfer = bus->max_transfer_sz;
+  mockBuses++;
+  return ESP_OK;
+}
+
+inline esp_err_t spi_bus_free(spi_host_device_t) {
+  mockBuses--;
+  return ESP_OK;
+}
+
+inline esp_err_t spi_bus_add_device(spi_host_device_t, const spi_device_interface_config_t *config,
+                                    spi_device_handle_t *device) {
+  *device = new spi_device_t();
+  (*device)->config = *config;
+  return ESP_OK;
+}
+
+inline esp_err_t spi_bus_remove_device(spi_device_handle_t device) {
+  if (!device->queue.empty()) mockFail("device removed with transactions queued");
+  delete device;
+  return ESP_OK;
+}
+
+inline esp_err_t spi_device_queue_trans(spi_device_handle_t device, spi_transaction_t *t, uint32_t) {
+  if ((int) device->queue.size() >= device->config.queue_size) mockFail("queue full");
+  if (!(t->flags & SPI_TRANS_USE_TXDATA)) {
+    if ((uintptr_t) t->tx_buffer & 3) mockFail("DMA buffer not word aligned");
+    if ((int) t->length / 8 > mockMaxTransfer) mockFail("transfer longer than max_transfer_sz");
+  }
+  for (size_t i = 0; i < device->queue.size(); i++) {
+    if (device->queue[i].transaction == t) mockFail("transaction queued twice");
+  }
+  const uint8_t *bytes = mockBytes(t);
+  device->queue.push_back({ t, std::vector<uint8_t>(bytes, bytes + t->length / 8) });
+  return ESP_OK;
+}
+
+inline esp_err_t spi_device_get_trans_result(spi_device_handle_t device, spi_transaction_t **t, uint32_t timeout) {
+  if (device->queue.empty()) {
+    if (timeout == portMAX_DELAY) mockFail("waiting for a result with nothing queued");
+    return ESP_ERR_TIMEOUT;
+  }
+  if (timeout != portMAX_DELAY) {
+    if (mockFinished <= 0) return ESP_ERR_TIMEOUT;
+    mockFinished--;
+  }
+
+  MockQueued queued = device->queue.front();
+  device->queue.pop_front();
+  if (memcmp(queued.bytes.data(), mockBytes(queued.transaction), queued.bytes.size()) != 0) {
+    mockFail("buffer changed before its transaction finished");
+  }
+  mockSend(device, queued.transaction);
+  *t = queued.transaction;
+  return ESP_OK;
+}
+
+inline esp_err_t spi_device_transmit(spi_device_handle_t device, spi_transaction_t *t) {
+  if (!device->queue.empty()) mockFail("polling transaction with transactions queued");
+  mockSend(device, t);
+  return ESP_OK;
+}
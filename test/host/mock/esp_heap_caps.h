@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stdlib.h>
+
+#define MALLOC_CAP_DMA 8
+
+// Fail the n-th allocation from now on, 0 for none
+extern int mockFailAllocation;
+
+inline void *heap_caps_malloc(size_t size, int) {
+  if (mockFailAllocation && --mockFailAllocation == 0) return NULL;
+  // malloc() aligns at least to words like the DMA capable heap
+  return malloc(size);
+}
+
+inline void heap_caps_free(void *p) { free(p); }
@@ -0,0 +1,155 @@
+// SSD1306SpiDma against the spi_master mock: the frames arrive intact although display()
+// returns before they are sent, and the staging buffers are only reused once sent.
+#define ARDUINO_ARCH_ESP32
+#include <assert.h>
+#include <stdio.h>
+#include "SSD1306SpiDma.h"
+
+int mockDataCommand;
+std::vector<MockTransfer> mockTransfers;
+int mockFinished;
+int mockBuses;
+int mockMaxTransfer;
+int mockFailAllocation;
+
+// The display memory of the panel in horizontal addressing mode, fed by the transfers
+struct Panel {
+  uint8_t ram[8][128];
+  int columnStart, columnEnd, pageStart, pageEnd, column, page;
+  std::vector<uint8_t> command;
+  size_t fed;
+
+  Panel() : columnStart(0), columnEnd(127), pageStart(0), pageEnd(7), column(0), page(0), fed(0) {
+    memset(ram, 0, sizeof(ram));
+  }
+
+  void feed() {
+    for (; fed < mockTransfers.size(); fed++) {
+      for (uint8_t b : mockTransfers[fed].bytes) {
+        if (mockTransfers[fed].dataCommand) data(b); else commandByte(b);
+      }
+    }
+  }
+
+  void commandByte(uint8_t b) {
+    command.push_back(b);
+    if ((command[0] == COLUMNADDR || command[0] == PAGEADDR) && command.size() < 3) return;
+    if (command[0] == COLUMNADDR) {
+      columnStart = column = command[1];
+      columnEnd = command[2];
+    } else if (command[0] == PAGEADDR) {
+      pageStart = page = command[1];
+      pageEnd = command[2];
+    }
+    command.clear();
+  }
+
+  void data(uint8_t b) {
+    ram[page & 7][column & 127] = b;
+    if (++column > columnEnd) {
+      column = columnStart;
+      if (++page > pageEnd) page = pageStart;
+    }
+  }
+
+  bool shows(const uint8_t *buffer) {
+    feed();
+    return memcmp(ram, buffer, sizeof(ram)) == 0;
+  }
+};
+
+static void drawSomething(OLEDDisplay &display) {
+  display.setColor((OLEDDISPLAY_COLOR) (rand() % 3));
+  display.fillRect(rand() % 128, rand() % 64, rand() % 60, rand() % 40);
+  display.drawString(rand() % 100, rand() % 50, "DMA");
+}
+
+static void testFlushWhileDrawing() {
+  SSD1306SpiDma &display = *new SSD1306SpiDma(1, 2, 3, 4, 5);
+  assert(display.init());
+  assert(display.isFlushing());
+  display.waitForFlush();
+  assert(!display.isFlushing());
+
+  Panel panel;
+  assert(panel.shows(display.buffer));
+
+  uint8_t frame[1024];
+  srand(9);
+  for (int round = 0; round < 300; round++) {
+    drawSomething(display);
+    display.display();
+    memcpy(frame, display.buffer, sizeof(frame));
+
+    // Drawing the next frame doesn't touch the one on the wire
+    display.setColor(INVERSE);
+    display.fillRect(0, 0, 128, 64);
+    mockFinished = rand() % 4;
+    display.isFlushing();
+    display.waitForFlush();
+    assert(!display.isFlushing());
+    assert(panel.shows(frame));
+
+    memcpy(display.buffer, frame, sizeof(frame));
+  }
+
+  // Frames faster than the bus: the staging buffers take turns, each one
+  // is filled again only after its transactions are finished
+  for (int round = 0; round < 100; round++) {
+    drawSomething(display);
+    display.display();
+    mockFinished = rand() % 3;
+    display.isFlushing();
+  }
+  display.waitForFlush();
+  assert(panel.shows(display.buffer));
+}
+
+static void testCommandsAfterQueuedWindows() {
+  SSD1306SpiDma &display = *new SSD1306SpiDma(1, 2, 3, 4, 5);
+  assert(display.init());
+  display.waitForFlush();
+
+  display.fillRect(0, 0, 10, 10);
+  display.display();
+  assert(display.isFlushing());
+
+  // A command waits for the windows, so it goes out behind their data
+  size_t transfers = mockTransfers.size();
+  display.setContrast(100);
+  assert(!display.isFlushing());
+  assert(mockTransfers.size() > transfers + 2);
+  assert(mockTransfers[transfers + 1].dataCommand == 1);
+  assert(mockTransfers.back().dataCommand == 0);
+}
+
+static void testAllocationFailure() {
+  SSD1306SpiDma &display = *new SSD1306SpiDma(1, 2, 3, 4, 5);
+  int buses = mockBuses;
+
+  // The second staging buffer can't be allocated: the bus is released again
+  mockFailAllocation = 2;
+  assert(!display.init());
+  assert(mockBuses == buses);
+
+  // and the next try starts over
+  assert(display.init());
+  assert(mockBuses == buses + 1);
+  display.waitForFlush();
+
+  Panel panel;
+  display.fillRect(3, 3, 50, 20);
+  display.display();
+  display.waitForFlush();
+  assert(panel.shows(display.buffer));
+}
+
+int main() {
+  testFlushWhileDrawing();
+  mockTransfers.clear();
+  testCommandsAfterQueuedWindows();
+  mockTransfers.clear();
+  testAllocationFailure();
+  printf("ok\n");
+  return 0;
+}